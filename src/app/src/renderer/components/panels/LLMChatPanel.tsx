@@ -314,7 +314,7 @@ const LLMChatPanel: React.FC<LLMChatPanelProps> = ({
 
     const response = await serverFetch('/chat/completions', {
       method: 'POST',
-      headers: { 'Content-Type': 'application/json' },
+      headers: { 'Content-Type': 'application/json', 'X-Lemonade-Priority': 'interactive' },
       body: JSON.stringify(buildChatRequestBody(messageHistory)),
       signal: abortControllerRef.current!.signal,
     });
@@ -1,4 +1,5 @@
 #include "lemon_cli/lemonade_client.h"
+#include "lemon/utils/path_utils.h"
 #include <httplib.h>
 #include <iostream>
 #include <iomanip>
@@ -22,9 +23,15 @@ std::string LemonadeClient::normalize_host(const std::string& host) const {
 }
 
 // Helper lambda to create and configure httplib::Client
+// Local servers are reached through the router's Unix socket when it is listening
 static httplib::Client make_client(const std::string& host, int port, const std::string& api_key,
                                     int connection_timeout = 30, int read_timeout = 30) {
-    httplib::Client cli(host, port);
+    std::string socket_path = lemon::utils::find_router_unix_socket(host, port);
+    httplib::Client cli = socket_path.empty() ? httplib::Client(host, port)
+                                              : httplib::Client(socket_path, port);
+    if (!socket_path.empty()) {
+        cli.set_address_family(AF_UNIX);
+    }
     cli.set_connection_timeout(connection_timeout);
     cli.set_read_timeout(read_timeout);
 
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+namespace audio {
+
+using json = nlohmann::json;
+
+// Long-audio transcription: split a recording at quiet points so the pieces can be
+// transcribed concurrently (one per whisper replica), then put the results back together
+// on the original timeline.
+namespace Chunking {
+    constexpr double TARGET_SECONDS = 30.0;     // Whisper's native window
+    constexpr double SEARCH_SECONDS = 5.0;      // Cut within +/- this of the target
+    constexpr double MIN_AUDIO_SECONDS = 60.0;  // Shorter audio is sent whole
+}
+
+struct AudioChunk {
+    std::string wav;       // 16 kHz mono PCM16 WAV
+    double offset_s = 0.0; // Start time in the original recording
+    double duration_s = 0.0;
+};
+
+// Whether the request opted into chunked transcription (chunking_strategy "auto" or
+// {"type": "server_vad"}, as in the OpenAI API)
+bool chunking_requested(const json& request);
+
+// Split a 16 kHz mono PCM16 WAV at the quietest 200ms within each search window.
+// Returns a single chunk when the audio is shorter than MIN_AUDIO_SECONDS, and nothing
+// when the data is not 16 kHz mono PCM16.
+std::vector<AudioChunk> split_at_silences(const std::string& wav);
+
+// Merge per-chunk responses into one response in the requested format ("json", "text",
+// "verbose_json", "srt" or "vtt"). Chunk responses must be verbose_json for the formats
+// with timestamps.
+json stitch_transcriptions(const std::vector<json>& responses,
+                           const std::vector<AudioChunk>& chunks,
+                           const std::string& response_format);
+
+} // namespace audio
+} // namespace lemon
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <utility>
 
 namespace lemon {
 namespace audio {
@@ -43,5 +45,20 @@ namespace Limits {
     constexpr double MAX_AUDIO_DURATION_SECONDS = 600.0;       // 10 minutes
 }
 
+// Encoded audio file (WAV, MP3, ...) to transcribe. The bytes are shared rather than copied
+// on their way from the HTTP upload or realtime buffer into the backend request.
+struct AudioPayload {
+    std::shared_ptr<const std::string> data;
+    std::string filename = "audio.wav";
+
+    AudioPayload() = default;
+    AudioPayload(std::string bytes, std::string name)
+        : data(std::make_shared<const std::string>(std::move(bytes))), filename(std::move(name)) {}
+
+    bool empty() const { return !data || data->empty(); }
+    size_t size() const { return data ? data->size() : 0; }
+    const std::string& bytes() const { return *data; }
+};
+
 } // namespace audio
 } // namespace lemon
@@ -49,7 +49,7 @@ public:
     json reranking(const json& request) override;
 
     // IAudioServer implementation
-    json audio_transcriptions(const json& request) override;
+    json audio_transcriptions(const json& request, const audio::AudioPayload& audio) override;
 
     // FLM uses /api/tags for readiness check instead of /health
     bool wait_for_ready();
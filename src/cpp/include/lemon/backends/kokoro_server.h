@@ -46,7 +46,7 @@ public:
     json responses(const json& request) override;
 
     // ITextToSpeechServer implementation
-    void audio_speech(const json& request, httplib::DataSink& sink) override;
+    bool audio_speech(const json& request, httplib::DataSink& sink) override;
 };
 
 } // namespace backends
@@ -2,7 +2,11 @@
 
 #include "../wrapped_server.h"
 #include "backend_utils.h"
+#include <condition_variable>
+#include <cstdint>
 #include <string>
+#include <mutex>
+#include <vector>
 
 namespace lemon {
 namespace backends {
@@ -48,6 +52,51 @@ public:
 
     // IRerankingServer implementation
     json reranking(const json& request) override;
+
+    // Streaming chat completions also go through the slot cache
+    void forward_streaming_request(const std::string& endpoint,
+                                   const std::string& request_body,
+                                   httplib::DataSink& sink,
+                                   bool sse = true,
+                                   long timeout_seconds = 0) override;
+
+private:
+    // Registry name -> GGUF path of a draft model, downloading it if needed (throws on failure)
+    std::string resolve_draft_model(const std::string& draft_model, bool do_not_upgrade);
+
+    // KV-cache slot persistence (recipe option "slot_cache")
+    // Each request runs in a slot it owns until its response finishes. A slot's state is
+    // swapped to disk when another conversation takes it over; replicas share the saved files.
+    struct Slot {
+        std::string conversation;   // Conversation whose state the slot holds
+        bool busy = false;          // Owned by an in-flight request
+        uint64_t last_used = 0;
+    };
+
+    // Claim a free slot for the request's conversation, waiting while all are busy, and restore
+    // the conversation's saved state into it. The caller sends the request with id_slot set
+    // to the result. Returns -1 when the request is not slot-managed.
+    int acquire_slot(const json& request);
+    void release_slot(int slot);
+
+    // Gives an acquired slot back when the request finishes, including on exceptions
+    struct SlotLease {
+        SlotLease(LlamaCppServer& server, int slot) : server(server), slot(slot) {}
+        ~SlotLease() { server.release_slot(slot); }
+        LlamaCppServer& server;
+        int slot;
+    };
+
+    bool slot_action(int slot, const std::string& action, const std::string& filename);
+    void save_slot(int slot, const std::string& conversation_key);
+    std::string slot_temp_suffix() const;   // Names this replica's unfinished saves
+    void prune_slot_cache();
+
+    std::string slot_cache_dir_;        // Empty when slot caching is disabled
+    std::vector<Slot> slots_;           // One per llama-server --parallel slot
+    uint64_t slot_clock_ = 0;
+    std::mutex slot_mutex_;
+    std::condition_variable slot_cv_;
 };
 
 } // namespace backends
@@ -46,7 +46,7 @@ public:
     json responses(const json& request) override;
 
     // IAudioServer implementation
-    json audio_transcriptions(const json& request) override;
+    json audio_transcriptions(const json& request, const audio::AudioPayload& audio) override;
 
 private:
     // NPU compiled cache handling
@@ -69,13 +69,13 @@ private:
                                          bool translate);
 
     // Forward audio data directly (no file I/O) using multipart form-data
-    json forward_multipart_audio_data(const std::string& audio_data,
-                                      const std::string& filename,
+    json forward_multipart_audio_data(const audio::AudioPayload& audio,
                                       const json& params,
                                       bool translate);
 
     std::string model_path_;
     std::filesystem::path temp_dir_;  // Directory for temporary audio files
+    bool ffmpeg_convert_ = false;     // Started with --convert: whisper-server converts every upload
 };
 
 } // namespace backends
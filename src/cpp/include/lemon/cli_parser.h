@@ -20,6 +20,29 @@ struct ServerConfig {
 
     // Multi-model support: Max loaded models per type slot
     int max_loaded_models = 1;
+
+    // Priority scheduling: concurrent requests per model replica (0 = unlimited)
+    int request_slots = 0;
+    double batch_share = 0.5;  // Share of a model's slots batch requests may hold
+
+    // HTTP worker pool: threads kept for control-plane requests, and the growth limit
+    int http_threads = 8;
+    int http_max_threads = 256;
+
+    // Seconds a streaming client may stop reading before it is dropped (0 = never)
+    int stream_stall_timeout = 120;
+
+    // HTTP connection tuning: keep-alive reuse, Nagle and socket buffers (0 = OS default)
+    int http_keep_alive_requests = 1000;
+    int http_keep_alive_timeout = 5;
+    bool http_tcp_nodelay = true;
+    int http_socket_buffer = 0;
+
+    // Unix domain socket for local clients: "auto" (runtime dir), "off", or a path
+    std::string unix_socket = "auto";
+
+    // Disk budget in MB for cached text-to-speech audio (0 = no cache)
+    int tts_cache_size = 0;
 };
 
 struct TrayConfig {
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <httplib.h>
+
+namespace lemon {
+namespace http_compression {
+
+// Bodies below this size are sent as-is by send_compressed()
+constexpr size_t MIN_COMPRESS_BYTES = 4 * 1024;
+
+// Content-Encodings this build can produce, in order of preference (zstd, br, gzip).
+// Which ones exist depends on the compression libraries httplib was built with.
+const std::vector<std::string>& available_encodings();
+
+// Available encodings allowed by an Accept-Encoding header (honours q=0), most preferred first
+std::vector<std::string> accepted_encodings(const std::string& accept_encoding);
+
+// First of accepted_encodings(), or "" when nothing matches
+std::string negotiate(const std::string& accept_encoding);
+
+// Whether a content type benefits from compression (JSON, text, JS, SVG)
+bool is_compressible(const std::string& content_type);
+
+// Compress a whole buffer. Returns false if the encoding is unavailable or fails.
+bool compress(const std::string& encoding, const std::string& input, std::string& output);
+
+// Set a response body, compressing it with the client's preferred encoding when it is
+// large enough to be worth it. Compressed bodies are sent through a sized content provider,
+// which httplib never compresses a second time.
+void send_compressed(const httplib::Request& req, httplib::Response& res,
+                     std::string body, const std::string& content_type);
+
+// A body kept in memory along with its compressed variants
+struct Representations {
+    std::shared_ptr<const std::string> identity;
+    std::map<std::string, std::shared_ptr<const std::string>> encoded;  // Content-Encoding -> bytes (null: not worth it)
+    std::string etag;  // Content hash, unquoted
+    std::string content_type;
+};
+
+// Send the variant of the client's most preferred accepted encoding, or identity when none
+// exists. Each variant gets its own strong ETag; a matching If-None-Match gets a 304.
+// The bytes are streamed from the shared buffer through a sized content provider.
+void send_representation(const httplib::Request& req, httplib::Response& res,
+                         const Representations& body, const std::string& cache_control, bool vary);
+
+// A serialized response shared by many requests (e.g. the /models list).
+// Carries a content-hash ETag and compresses itself at most once per encoding.
+class CachedBody {
+public:
+    CachedBody(std::string body, std::string content_type);
+
+    // Reply 304 when If-None-Match matches; otherwise send the body with the client's
+    // preferred encoding straight from the cached buffers
+    void send(const httplib::Request& req, httplib::Response& res);
+
+private:
+    std::mutex mutex_;
+    Representations body_;  // encoded is filled in lazily under mutex_
+};
+
+} // namespace http_compression
+} // namespace lemon
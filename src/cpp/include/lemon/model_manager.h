@@ -4,6 +4,7 @@
 #include <map>
 #include <vector>
 #include <mutex>
+#include <memory>
 #include <functional>
 #include <nlohmann/json.hpp>
 #include "model_types.h"
@@ -59,6 +60,9 @@ struct ModelInfo {
     // Image generation defaults (for sd-cpp models)
     ImageDefaults image_defaults;
 
+    // Speculative decoding: registry-suggested draft model (llamacpp models)
+    std::string draft_model;
+
     // Utility
     std::string checkpoint(const std::string& type = "main") const { return checkpoints.count(type) ? checkpoints.at(type) : ""; }
     std::string resolved_path(const std::string& type = "main") const { return resolved_paths.count(type) ? resolved_paths.at(type) : ""; }
@@ -66,6 +70,9 @@ struct ModelInfo {
     std::string mmproj() const { return checkpoint("mmproj"); }
 };
 
+// Immutable view of the models cache; stays valid (and unchanged) after the cache moves on
+using ModelSnapshot = std::shared_ptr<const std::map<std::string, ModelInfo>>;
+
 class ModelManager {
 public:
     ModelManager();
@@ -79,6 +86,11 @@ public:
     // Get downloaded models
     std::map<std::string, ModelInfo> get_downloaded_models();
 
+    // Shared snapshot of all supported models, without copying the cache per call.
+    // version (optional) receives the cache version the snapshot belongs to; it changes
+    // whenever a model is added, removed, downloaded or has its options updated.
+    ModelSnapshot get_models_snapshot(uint64_t* version = nullptr);
+
     // Filter models by available backends
     std::map<std::string, ModelInfo> filter_models_by_backend(
         const std::map<std::string, ModelInfo>& models);
@@ -181,6 +193,11 @@ private:
     mutable std::map<std::string, ModelInfo> models_cache_;
     mutable std::map<std::string, std::string> filtered_out_models_;  // model_name -> filter reason
     mutable bool cache_valid_ = false;
+    uint64_t cache_version_ = 0;
+    ModelSnapshot snapshot_;  // Built lazily for the current cache_version_
+
+    // Record a change to models_cache_ (caller must hold models_cache_mutex_)
+    void mark_cache_changed();
 };
 
 } // namespace lemon
@@ -5,11 +5,13 @@
 #include <unordered_map>
 #include <mutex>
 #include <functional>
-#include <future>
 #include <atomic>
 #include <nlohmann/json.hpp>
+#include "audio_types.h"
 #include "streaming_audio_buffer.h"
 #include "vad.h"
+#include "transcript_stitcher.h"
+#include "transcription_executor.h"
 
 namespace lemon {
 
@@ -25,7 +27,7 @@ struct RealtimeSession {
     std::string session_id;
     std::string model;
     StreamingAudioBuffer audio_buffer;
-    SimpleVAD vad;
+    std::unique_ptr<VoiceActivityDetector> vad;  // Engine chosen by turn_detection.type
     std::atomic<bool> session_active{true};
 
     // Callback to send messages back to the WebSocket client
@@ -38,8 +40,14 @@ struct RealtimeSession {
     int64_t last_interim_transcription_ms = 0;  // When we last fired an interim transcription
     std::atomic<bool> interim_in_flight{false};  // Guard against overlapping interim requests
 
+    // Sliding-window interim state (guarded by interim_mutex)
+    std::mutex interim_mutex;
+    TranscriptStitcher stitcher;
+    size_t window_start_sample = 0;  // Interim passes only transcribe audio from here on
+    uint64_t utterance = 0;          // Bumped when an utterance ends, so late interim results are dropped
+
     RealtimeSession(const std::string& id)
-        : session_id(id), vad(SimpleVAD::Config{}) {}
+        : session_id(id), vad(std::make_unique<SimpleVAD>()) {}
 };
 
 /**
@@ -52,6 +60,16 @@ public:
     // Lower values feel more "real-time" but increase Whisper load.
     static constexpr int INTERIM_TRANSCRIPTION_CHUNK_MS = 1000;
 
+    // Interim passes transcribe a trailing window instead of the whole utterance. Once the
+    // window is longer than INTERIM_WINDOW_MS its start moves to the end of the committed
+    // text; INTERIM_MAX_WINDOW_MS caps it when no segment boundary has been committed.
+    static constexpr int INTERIM_WINDOW_MS = 8000;
+    static constexpr int INTERIM_MAX_WINDOW_MS = 16000;
+
+    // Worker threads shared by all sessions' transcriptions. Per model, concurrency is
+    // further capped at the number of backend replicas.
+    static constexpr size_t TRANSCRIPTION_WORKERS = 4;
+
     explicit RealtimeSessionManager(Router* router);
     ~RealtimeSessionManager();
 
@@ -84,6 +102,14 @@ public:
      */
     void append_audio(const std::string& session_id, const std::string& base64_audio);
 
+    /**
+     * Append raw PCM16 audio to a session (binary WebSocket frames).
+     * @param session_id Session to append to
+     * @param data Little-endian PCM16 mono bytes at the session's input sample rate
+     * @param size Number of bytes
+     */
+    void append_audio_raw(const std::string& session_id, const uint8_t* data, size_t size);
+
     /**
      * Commit the current audio buffer (force transcription).
      * @param session_id Session to commit
@@ -107,15 +133,16 @@ public:
      */
     bool session_exists(const std::string& session_id) const;
 
+    /**
+     * Session count and transcription queue metrics (for /health).
+     */
+    json get_stats() const;
+
 private:
     Router* router_;
     std::unordered_map<std::string, std::shared_ptr<RealtimeSession>> sessions_;
     mutable std::mutex sessions_mutex_;
 
-    // Pending transcription futures for clean shutdown
-    std::vector<std::future<void>> pending_transcriptions_;
-    std::mutex transcriptions_mutex_;
-
     // Generate unique session ID
     static std::string generate_session_id();
 
@@ -128,17 +155,38 @@ private:
     // Check whether an interim transcription should fire and trigger it
     void maybe_interim_transcribe(std::shared_ptr<RealtimeSession> session);
 
-    // Run Whisper transcription (executes on worker thread)
-    // When is_interim is true the result is sent as a delta event.
+    // Run Whisper transcription (executes on worker thread) and send the final transcript,
+    // prefixed with text already frozen by the interim window
     void transcribe_wav(std::shared_ptr<RealtimeSession> session,
-                        std::vector<uint8_t> wav_data, std::string model,
-                        bool is_interim = false);
+                        audio::AudioPayload wav, std::string model,
+                        std::string prompt, std::string frozen_text);
+
+    // Transcribe one interim window, stitch it into the session transcript and send a delta
+    void transcribe_window(std::shared_ptr<RealtimeSession> session,
+                           audio::AudioPayload wav, std::string model, std::string prompt,
+                           size_t window_start, size_t window_end, uint64_t utterance);
+
+    // Call the router for a WAV snapshot (throws on transport errors)
+    json request_transcription(const audio::AudioPayload& wav, const std::string& model,
+                               const std::string& prompt, bool timestamps);
+
+    // Report a transcription failure to the client
+    void send_transcription_error(std::shared_ptr<RealtimeSession> session, const std::exception& e);
+
+    // Forget interim window state when an utterance ends or is discarded
+    static void reset_interim(RealtimeSession& session);
+
+    // Log buffer growth and run VAD after audio was appended
+    void on_audio_appended(std::shared_ptr<RealtimeSession> session);
 
     // Process VAD for a session
     void process_vad(std::shared_ptr<RealtimeSession> session);
 
     // Get session by ID (returns nullptr if not found)
     std::shared_ptr<RealtimeSession> get_session(const std::string& session_id);
+
+    // Runs every session's transcriptions (declared last so it stops before sessions go away)
+    TranscriptionExecutor executor_;
 };
 
 } // namespace lemon
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+
+namespace lemon {
+
+// Priority class of an inference request
+// INTERACTIVE requests are admitted first, BATCH requests last and only up to a share of the
+// slots (at least one, so with a single slot batch can still occupy it)
+enum class RequestPriority {
+    INTERACTIVE = 0,
+    NORMAL = 1,
+    BATCH = 2
+};
+
+// Parse "interactive", "normal" or "batch" (case-insensitive). Unknown values map to NORMAL.
+RequestPriority request_priority_from_string(const std::string& value);
+std::string request_priority_to_string(RequestPriority priority);
+
+// Per-model admission control for inference requests.
+// Each model gets slots_per_replica * replicas concurrent requests; the rest wait here
+// (instead of in the backend's own FIFO) so higher priority classes can overtake them.
+class RequestScheduler {
+public:
+    // slots_per_replica <= 0 disables admission control (every request is dispatched immediately)
+    void configure(int slots_per_replica, double batch_share);
+    bool is_enabled() const { return slots_per_replica_ > 0; }
+
+    // Priority of the request being handled on the calling thread.
+    // Set by the HTTP layer before routing; defaults to NORMAL.
+    static void set_current_priority(RequestPriority priority);
+    static RequestPriority current_priority();
+
+    // Block until a request of the given priority may be dispatched to model_name
+    void acquire(const std::string& model_name, int replicas, RequestPriority priority);
+
+    // Return the slot taken by acquire()
+    void release(const std::string& model_name, RequestPriority priority);
+
+    // Whether requests for model_name are admitted or waiting for a slot
+    bool has_pending(const std::string& model_name);
+
+    // RAII holder for an admitted request (no-op when the scheduler is disabled)
+    class Admission {
+    public:
+        Admission(RequestScheduler& scheduler, const std::string& model_name,
+                  int replicas, RequestPriority priority);
+        ~Admission();
+
+        Admission(const Admission&) = delete;
+        Admission& operator=(const Admission&) = delete;
+
+    private:
+        RequestScheduler& scheduler_;
+        std::string model_name_;
+        RequestPriority priority_;
+        bool admitted_;
+    };
+
+private:
+    struct ModelQueue {
+        int active = 0;
+        int active_batch = 0;
+        int waiting[3] = {0, 0, 0};  // Indexed by RequestPriority
+    };
+
+    bool can_admit(const ModelQueue& queue, int capacity, RequestPriority priority) const;
+
+    int slots_per_replica_ = 0;
+    double batch_share_ = 0.5;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<std::string, ModelQueue> queues_;
+};
+
+} // namespace lemon
@@ -5,11 +5,14 @@
 #include <mutex>
 #include <condition_variable>
 #include <vector>
+#include <thread>
 #include <nlohmann/json.hpp>
 #include <httplib.h>
 #include "wrapped_server.h"
 #include "model_manager.h"
 #include "backend_manager.h"
+#include "request_scheduler.h"
+#include "speech_cache.h"
 
 namespace lemon {
 
@@ -35,6 +38,10 @@ public:
     // Unload model(s)
     void unload_model(const std::string& model_name = "");  // Empty = unload all
 
+    // Override how long a loaded model may stay idle before it is unloaded
+    // (-1 = never, 0 = as soon as in-flight requests finish). Also restarts the idle timer.
+    void set_keep_alive(const std::string& model_name, int seconds);
+
     // Get the most recently loaded model info (for backward compatibility)
     std::string get_loaded_model() const;
     std::string get_loaded_recipe() const;
@@ -51,6 +58,9 @@ public:
     // Check if a specific model is loaded
     bool is_model_loaded(const std::string& model_name) const;
 
+    // Number of backend processes currently serving a model (0 if not loaded)
+    int get_loaded_replicas(const std::string& model_name) const;
+
     // Get the model type for a loaded model (returns LLM if not found)
     ModelType get_model_type(const std::string& model_name = "") const;
 
@@ -65,18 +75,24 @@ public:
     json responses(const json& request);
 
     // Audio endpoints (OpenAI /v1/audio/* compatible)
-    json audio_transcriptions(const json& request);
-    void audio_speech(const json& request, httplib::DataSink& sink);
+    json audio_transcriptions(const json& request, const audio::AudioPayload& audio);
+    // Returns true when the complete audio reached the sink (failed streams are not cached)
+    bool audio_speech(const json& request, httplib::DataSink& sink);
+
+    // Speak a chat completion while it is generated: each sentence is sent to the TTS model
+    // as soon as the LLM finishes it, and its PCM audio is streamed to the sink
+    void audio_speech_from_chat(const json& speech_request, const json& chat_request, httplib::DataSink& sink);
 
     // Image endpoints (OpenAI /v1/images/* compatible)
     json image_generations(const json& request);
     json image_edits(const json& request);
     json image_variations(const json& request);
 
-    // Forward streaming requests to the appropriate wrapped server
-    void chat_completion_stream(const std::string& request_body, httplib::DataSink& sink);
-    void completion_stream(const std::string& request_body, httplib::DataSink& sink);
-    void responses_stream(const std::string& request_body, httplib::DataSink& sink);
+    // Forward streaming requests to the appropriate wrapped server. Callers pass the model
+    // from the request they already parsed, so the body is forwarded without another scan.
+    void chat_completion_stream(const std::string& model, const std::string& request_body, httplib::DataSink& sink);
+    void completion_stream(const std::string& model, const std::string& request_body, httplib::DataSink& sink);
+    void responses_stream(const std::string& model, const std::string& request_body, httplib::DataSink& sink);
 
     // Get telemetry data
     json get_stats() const;
@@ -88,6 +104,17 @@ public:
     // Update prompt_tokens field from usage
     void update_prompt_tokens(int prompt_tokens);
 
+    // Update speculative decoding counters (non-streaming requests)
+    void update_draft_telemetry(int draft_tokens, int draft_tokens_accepted);
+
+    // Priority scheduling: concurrent requests admitted per replica (0 = unlimited)
+    // and the share of those slots batch requests may hold
+    void configure_scheduling(int slots_per_replica, double batch_share);
+
+    // Text-to-speech cache: directory and size budget in bytes (0 disables it)
+    void configure_speech_cache(const std::string& dir, uint64_t budget_bytes);
+    json get_speech_cache_stats() const;
+
 private:
     // Multi-model support: Manage multiple WrappedServers
     std::vector<std::unique_ptr<WrappedServer>> loaded_servers_;
@@ -106,8 +133,24 @@ private:
     bool is_loading_ = false;                    // True when a load operation is in progress
     std::condition_variable load_cv_;            // Signals when load completes
 
+    // Per-model admission control for priority classes
+    RequestScheduler scheduler_;
+
+    // Synthesized speech replayed from disk for repeated phrases
+    SpeechCache speech_cache_;
+
+    // Idle reaper: unloads models whose keep-alive has expired
+    std::thread idle_reaper_thread_;
+    std::condition_variable idle_reaper_cv_;     // Waits on load_mutex_
+    bool stop_idle_reaper_ = false;
+    void idle_reaper_loop();
+    // Caller holds load_mutex_ through `lock`; it is released while expired models unload
+    void unload_idle_models(std::unique_lock<std::mutex>& lock);
+
     // Helper methods for multi-model management
     WrappedServer* find_server_by_model_name(const std::string& model_name) const;
+    WrappedServer* find_least_busy_server(const std::string& model_name) const;
+    int count_replicas(const std::string& model_name) const;
     WrappedServer* get_most_recent_server() const;
     int count_servers_by_type(ModelType type) const;
     WrappedServer* find_lru_server_by_type(ModelType type) const;
@@ -117,16 +160,27 @@ private:
     WrappedServer* find_flm_server_by_type(ModelType type) const;
     void evict_all_npu_servers();
     void evict_server(WrappedServer* server);
+    void evict_model(const std::string& model_name);
     void evict_all_servers();
     std::unique_ptr<WrappedServer> create_backend_server(const ModelInfo& model_info);
 
+    // Create and start every replica for a model (called without holding load_mutex_)
+    std::vector<std::unique_ptr<WrappedServer>> load_replicas(const std::string& model_name,
+                                                              const ModelInfo& model_info,
+                                                              const RecipeOptions& options,
+                                                              bool do_not_upgrade);
+
+    // Long audio: split at silences, transcribe the chunks concurrently across replicas and
+    // stitch the results (returns null when the request can't be chunked)
+    json transcribe_in_chunks(const json& request, const audio::AudioPayload& audio);
+
     // Generic inference wrapper that handles locking and busy state
     template<typename Func>
     auto execute_inference(const json& request, Func&& inference_func) -> decltype(inference_func(nullptr));
 
-    // Generic streaming wrapper
+    // Generic streaming wrapper (requested_model comes from the caller so the body is never re-parsed)
     template<typename Func>
-    void execute_streaming(const std::string& request_body, httplib::DataSink& sink, Func&& streaming_func);
+    void execute_streaming(const std::string& requested_model, httplib::DataSink& sink, Func&& streaming_func);
 };
 
 } // namespace lemon
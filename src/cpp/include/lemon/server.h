@@ -1,19 +1,19 @@
 #pragma once
 
-// CRITICAL: Define thread pool count BEFORE including httplib.h
-#ifndef CPPHTTPLIB_THREAD_POOL_COUNT
-#define CPPHTTPLIB_THREAD_POOL_COUNT 8
-#endif
-
 #include <string>
 #include <thread>
 #include <memory>
 #include <atomic>
+#include <mutex>
 #include <chrono>
 #include <httplib.h>
 #include "router.h"
 #include "model_manager.h"
 #include "backend_manager.h"
+#include "cli_parser.h"
+#include "worker_pool.h"
+#include "static_asset_cache.h"
+#include "http_compression.h"
 #ifdef LEMON_HAS_WEBSOCKET
 #include "websocket_server.h"
 #endif
@@ -23,14 +23,7 @@ namespace lemon {
 
 class Server {
 public:
-    Server(int port,
-           const std::string& host,
-           const std::string& log_level,
-           const json& default_options,
-           int max_loaded_models,
-           const std::string& extra_models_dir,
-           bool no_broadcast,
-           long http_timeout);
+    explicit Server(const ServerConfig& config);
 
     ~Server();
 
@@ -49,7 +42,7 @@ private:
     void setup_static_files(httplib::Server &web_server);
     void setup_cors(httplib::Server &web_server);
     void setup_http_logger(httplib::Server &web_server);
-    void log_request(const httplib::Request& req);
+    void log_request(const httplib::Request& req, httplib::Response& res);
     httplib::Server::HandlerResponse authenticate_request(const httplib::Request& req, httplib::Response& res);
 
     // Endpoint handlers
@@ -68,6 +61,7 @@ private:
     void handle_delete(const httplib::Request& req, httplib::Response& res);
     void handle_params(const httplib::Request& req, httplib::Response& res);
     void handle_stats(const httplib::Request& req, httplib::Response& res);
+    void handle_debug_trace(const httplib::Request& req, httplib::Response& res);
     void handle_system_info(const httplib::Request& req, httplib::Response& res);
     void handle_system_stats(const httplib::Request& req, httplib::Response& res);
     void handle_log_level(const httplib::Request& req, httplib::Response& res);
@@ -134,11 +128,33 @@ private:
 
     std::thread http_v4_thread_;
     std::thread http_v6_thread_;
+    std::thread http_unix_thread_;
 
 
     std::unique_ptr<httplib::Server> http_server_;
     std::unique_ptr<httplib::Server> http_server_v6_;
 
+    // Unix domain socket listener for local clients (null when disabled or on Windows)
+    std::unique_ptr<httplib::Server> http_server_unix_;
+    std::string unix_socket_path_;
+    std::atomic<bool> unix_socket_listening_{false};
+
+    // Worker pools behind each listener (shared with the httplib task queue adapters)
+    std::shared_ptr<WorkerPool> http_pool_;
+    std::shared_ptr<WorkerPool> http_pool_v6_;
+    std::shared_ptr<WorkerPool> http_pool_unix_;
+
+    // Web app files (shared by both listeners)
+    std::shared_ptr<StaticAssetCache> web_app_assets_;
+
+    // Serialized /models responses ([0] downloaded only, [1] show_all) for a model cache version
+    struct CachedModelsResponse {
+        uint64_t version = 0;
+        std::shared_ptr<http_compression::CachedBody> body;
+    };
+    std::mutex models_response_mutex_;
+    CachedModelsResponse models_response_[2];
+
     std::unique_ptr<Router> router_;
     std::unique_ptr<ModelManager> model_manager_;
     std::unique_ptr<BackendManager> backend_manager_;
@@ -149,6 +165,7 @@ private:
     bool running_;
 
     std::string api_key_;
+    std::string batch_api_key_;  // Requests authenticated with this key are scheduled as batch
     NetworkBeacon udp_beacon_;
 
     // CPU usage tracking
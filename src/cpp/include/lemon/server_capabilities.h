@@ -2,6 +2,7 @@
 
 #include <nlohmann/json.hpp>
 #include <httplib.h>
+#include "audio_types.h"
 
 namespace lemon {
 
@@ -40,8 +41,9 @@ class IAudioServer : public virtual ICapability {
 public:
     virtual ~IAudioServer() = default;
 
-    // Speech-to-text transcription (OpenAI /v1/audio/transcriptions compatible)
-    virtual json audio_transcriptions(const json& request) = 0;
+    // Speech-to-text transcription (OpenAI /v1/audio/transcriptions compatible). The request
+    // holds the form parameters (model, language, prompt, ...), the audio travels separately.
+    virtual json audio_transcriptions(const json& request, const audio::AudioPayload& audio) = 0;
 };
 
 // Optional audio capability (text-to-speech)
@@ -49,8 +51,9 @@ class ITextToSpeechServer : public virtual ICapability {
 public:
     virtual ~ITextToSpeechServer() = default;
 
-    // Speech-to-text transcription (OpenAI /v1/audio/speech compatible)
-    virtual void audio_speech(const json& request, httplib::DataSink& sink) = 0;
+    // Speech-to-text transcription (OpenAI /v1/audio/speech compatible).
+    // Returns true when the complete audio reached the client.
+    virtual bool audio_speech(const json& request, httplib::DataSink& sink) = 0;
 };
 
 // Optional image generation capability
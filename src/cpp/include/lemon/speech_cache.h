@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include <httplib.h>
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+// On-disk cache of synthesized speech.
+//
+// Voice UIs keep speaking the same phrases ("Sure, one moment", menu items), so audio is
+// stored per (model, voice, speed, format, text) and replayed from disk instead of being
+// synthesized again. Each file starts with its full key, so a hash collision is a miss.
+// Entries are evicted least recently used first once the size budget is exceeded; the
+// order survives restarts through the files' modification times.
+class SpeechCache {
+public:
+    static constexpr size_t REPLAY_CHUNK_BYTES = 16 * 1024;  // Same size as live stream chunks
+
+    // Enable the cache in dir with a budget in bytes (0 disables it)
+    void configure(const std::string& dir, uint64_t budget_bytes);
+
+    bool enabled() const;
+
+    // Cache key of a speech request (empty when it can't be cached)
+    static std::string request_key(const json& request);
+
+    // Stream the cached audio for key into sink; false on a miss, before anything is written
+    bool replay(const std::string& key, httplib::DataSink& sink);
+
+    // Save the audio produced for key. Error responses and entries larger than a quarter
+    // of the budget are not stored.
+    void store(const std::string& key, const std::string& audio);
+
+    json get_stats() const;
+
+private:
+    struct Entry {
+        std::list<std::string>::iterator lru;
+        uint64_t size = 0;
+    };
+
+    static std::string file_name(const std::string& key);
+    void touch(const std::string& name);        // Caller must hold mutex_
+    void forget(const std::string& name);       // Caller must hold mutex_
+    void evict_over_budget();                   // Caller must hold mutex_
+
+    mutable std::mutex mutex_;
+    std::filesystem::path dir_;
+    uint64_t budget_bytes_ = 0;
+    uint64_t total_bytes_ = 0;
+    std::list<std::string> lru_;                // File names, most recently used first
+    std::unordered_map<std::string, Entry> entries_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+} // namespace lemon
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace lemon {
+namespace audio {
+
+// Streaming text-to-speech: cut LLM output into pieces that can be spoken on their own
+// while the model is still generating.
+namespace Segmenting {
+    constexpr size_t FIRST_CLAUSE_CHARS = 48;  // First piece may end at a comma once this long
+    constexpr size_t MIN_CHARS = 40;           // Later sentences shorter than this are merged
+    constexpr size_t MAX_CHARS = 300;          // Longer text is cut at a clause or word break
+}
+
+// Splits text arriving in arbitrary fragments (token deltas) into sentences. The first
+// piece is returned as early as possible to keep time-to-first-audio low; later pieces are
+// longer, since they are synthesized while earlier audio plays. Markdown emphasis and
+// <think>...</think> blocks are dropped.
+class SentenceSegmenter {
+public:
+    // Append generated text
+    void push(const std::string& text);
+
+    // Next complete sentence, if one is ready
+    bool next(std::string& sentence);
+
+    // Remaining text once generation has finished (call until it returns false)
+    bool flush(std::string& sentence);
+
+private:
+    // Position just past the boundary that ends the next sentence (0 = none yet)
+    size_t find_boundary() const;
+    bool take(size_t end, std::string& sentence);
+
+    std::string pending_;   // Speakable text not yet returned
+    std::string raw_;       // Tail that may hold a partial <think> tag
+    bool in_think_ = false;
+    bool first_ = true;
+};
+
+} // namespace audio
+} // namespace lemon
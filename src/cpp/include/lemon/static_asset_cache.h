@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <filesystem>
+#include <httplib.h>
+#include "lemon/http_compression.h"
+
+namespace lemon {
+
+// In-memory cache for the web app's static files.
+//
+// Each file is read once, given a content-hash ETag and compressed ahead of time with every
+// encoding httplib was built with (zstd, brotli, gzip), so a request only picks a variant
+// and streams it from memory. Files whose names carry a content hash (renderer.1a2b3c4d.js)
+// are served as immutable; everything else must be revalidated, which costs a 304.
+// A cached entry is rebuilt when the file's modification time changes. Paths that would
+// leave the root directory (absolute, "..", symlinks pointing outside) are not served.
+class StaticAssetCache {
+public:
+    // Upper bound on cached bytes, all encodings included
+    static constexpr size_t MAX_CACHED_BYTES = 64 * 1024 * 1024;
+
+    // Smaller files are not worth a compressed variant. Lower than the limit for API
+    // bodies, since a file is compressed once and then served many times.
+    static constexpr size_t MIN_COMPRESS_BYTES = 1024;
+
+    // Rewrites a file's contents before it is cached (e.g. to inject scripts into index.html)
+    using Transform = std::function<std::string(std::string)>;
+
+    explicit StaticAssetCache(const std::string& root_dir);
+
+    void set_transform(const std::string& relative_path, Transform transform);
+
+    // Load (and compress) a file ahead of the first request
+    void warm(const std::string& relative_path);
+
+    // Serve root_dir/relative_path, honouring If-None-Match and Accept-Encoding
+    void serve(const httplib::Request& req, httplib::Response& res, const std::string& relative_path);
+
+    static std::string content_type_for(const std::string& path);
+
+private:
+    struct Asset {
+        http_compression::Representations body;
+        std::filesystem::file_time_type mtime;
+        bool immutable = false;
+        size_t bytes = 0;  // Identity plus encoded variants
+    };
+
+    // Map a request path to a file under the root and its cache key; false if it escapes
+    bool resolve(const std::string& relative_path, std::filesystem::path& full_path, std::string& key) const;
+    std::shared_ptr<const Asset> load(const std::string& relative_path);
+
+    std::filesystem::path root_dir_;
+    std::filesystem::path canonical_root_;
+    std::mutex mutex_;
+    size_t cached_bytes_ = 0;
+    std::map<std::string, std::shared_ptr<const Asset>> assets_;
+    std::map<std::string, Transform> transforms_;
+};
+
+} // namespace lemon
@@ -3,13 +3,20 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include <memory>
 #include <cstdint>
+#include "utils/audio_utils.h"
 
 namespace lemon {
 
 /**
  * Thread-safe audio buffer for streaming transcription.
  * Accumulates PCM audio chunks and exports as WAV for whisper.cpp.
+ *
+ * Built for many concurrent sessions appending small chunks: storage is reserved up
+ * front and kept across clear(), base64 is decoded straight into it, the most recent
+ * second is kept as float32 (converted once, on append) for VAD, and WAV exports are
+ * written into a single buffer.
  */
 class StreamingAudioBuffer {
 public:
@@ -17,13 +24,23 @@ public:
     static constexpr int CHANNELS = 1;          // Mono
     static constexpr int BITS_PER_SAMPLE = 16;  // PCM16
 
-    StreamingAudioBuffer() = default;
+    static constexpr size_t RESERVED_SAMPLES = SAMPLE_RATE * 10;  // Utterance storage reserved up front
+    static constexpr size_t TAIL_SAMPLES = SAMPLE_RATE;           // Float32 tail kept for VAD (1s)
+
+    StreamingAudioBuffer();
     ~StreamingAudioBuffer() = default;
 
     // Non-copyable
     StreamingAudioBuffer(const StreamingAudioBuffer&) = delete;
     StreamingAudioBuffer& operator=(const StreamingAudioBuffer&) = delete;
 
+    /**
+     * Set the sample rate of appended audio. Audio at other rates is resampled to
+     * SAMPLE_RATE as it is appended. Call before appending (resets the resampler).
+     * @param sample_rate Input sample rate in Hz
+     */
+    void set_input_sample_rate(int sample_rate);
+
     /**
      * Append base64-encoded PCM16 audio data to the buffer.
      * @param base64_audio Base64-encoded PCM16 mono 16kHz audio
@@ -36,11 +53,19 @@ public:
      */
     void append_raw(const std::vector<int16_t>& samples);
 
+    /**
+     * Append little-endian PCM16 bytes directly (e.g. a binary WebSocket frame).
+     * A trailing odd byte is ignored.
+     * @param data Raw PCM16 mono 16kHz bytes
+     * @param size Number of bytes
+     */
+    void append_raw(const uint8_t* data, size_t size);
+
     /**
      * Get the accumulated audio as a WAV file in memory.
      * @return WAV file bytes ready to write to disk or send to whisper
      */
-    std::vector<uint8_t> get_wav() const;
+    std::string get_wav() const;
 
     /**
      * Get the accumulated audio as a WAV file, padded with silence to a minimum duration.
@@ -48,7 +73,15 @@ public:
      * @param min_duration_ms Minimum audio duration in milliseconds (default 1250ms)
      * @return WAV file bytes with silence padding if needed
      */
-    std::vector<uint8_t> get_wav_padded(int min_duration_ms = 1250) const;
+    std::string get_wav_padded(int min_duration_ms = 1250) const;
+
+    /**
+     * Get the audio from a sample offset to the end as a WAV file, padded like get_wav_padded().
+     * Used to transcribe a trailing window of a long utterance.
+     * @param start_sample First sample to include (clamped to the buffer size)
+     * @param min_duration_ms Minimum audio duration in milliseconds
+     */
+    std::string get_wav_from(size_t start_sample, int min_duration_ms = 1250) const;
 
     /**
      * Get the accumulated audio as float32 samples (for VAD processing).
@@ -56,6 +89,20 @@ public:
      */
     std::vector<float> get_samples() const;
 
+    /**
+     * Get the audio from a sample offset to the end as float32 samples.
+     * @param start_sample First sample to include (clamped to the buffer size)
+     * @return Float32 samples normalized to [-1.0, 1.0]
+     */
+    std::vector<float> get_samples_from(size_t start_sample) const;
+
+    /**
+     * Like get_samples_from(), but reuses the caller's vector to avoid allocating per call.
+     * @param start_sample First sample to include (clamped to the buffer size)
+     * @param out Receives the float32 samples (resized to fit)
+     */
+    void get_samples_from(size_t start_sample, std::vector<float>& out) const;
+
     /**
      * Get the most recent N milliseconds of audio as float32 samples.
      * @param ms Number of milliseconds of audio to retrieve
@@ -63,6 +110,11 @@ public:
      */
     std::vector<float> get_recent_samples(int ms) const;
 
+    /**
+     * Like get_recent_samples(), but reuses the caller's vector to avoid allocating per call.
+     */
+    void get_recent_samples(int ms, std::vector<float>& out) const;
+
     /**
      * Clear the audio buffer.
      */
@@ -85,10 +137,27 @@ public:
 
 private:
     std::vector<int16_t> samples_;
+    std::vector<float> tail_;      // Ring of the last TAIL_SAMPLES samples as float32
+    size_t tail_pos_ = 0;          // Next write position in tail_
     mutable std::mutex mutex_;
 
-    // Helper to build WAV from samples (no locking — caller must hold mutex_)
-    static std::vector<uint8_t> build_wav(const std::vector<int16_t>& samples);
+    // Input rate conversion (null when clients send SAMPLE_RATE audio)
+    std::unique_ptr<utils::AudioResampler> resampler_;
+    std::vector<float> resample_in_;
+    std::vector<float> resample_out_;
+
+    // Resample samples appended from old_size on (if needed) and update the float tail
+    // (caller must hold mutex_)
+    void finish_append(size_t old_size);
+
+    // Convert newly appended samples into the float tail (caller must hold mutex_)
+    void update_tail(const int16_t* samples, size_t count);
+
+    // Copy samples [start, end) to out, from the float tail when it covers them (caller must hold mutex_)
+    void copy_samples(size_t start, size_t end, std::vector<float>& out) const;
+
+    // Helper to build WAV from samples, zero-padded to min_samples (no locking — caller must hold mutex_)
+    static std::string build_wav(const int16_t* samples, size_t count, size_t min_samples = 0);
 };
 
 } // namespace lemon
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <functional>
 #include <nlohmann/json.hpp>
@@ -19,6 +21,8 @@ public:
         int output_tokens = 0;
         double time_to_first_token = 0.0;
         double tokens_per_second = 0.0;
+        int draft_tokens = 0;
+        int draft_tokens_accepted = 0;
 
         void print() const {
             if (input_tokens > 0 || output_tokens > 0) {
@@ -29,6 +33,11 @@ public:
                           << time_to_first_token << std::endl;
                 LOG(INFO, "Telemetry") << "TPS:           " << std::fixed << std::setprecision(2)
                           << tokens_per_second << std::endl;
+                if (draft_tokens > 0) {
+                    LOG(INFO, "Telemetry") << "Draft accept:  " << draft_tokens_accepted << "/" << draft_tokens
+                              << " (" << std::fixed << std::setprecision(1)
+                              << (100.0 * draft_tokens_accepted / draft_tokens) << "%)" << std::endl;
+                }
                 LOG(INFO, "Telemetry") << "=================" << std::endl;
             }
         }
@@ -43,16 +52,32 @@ public:
         long timeout_seconds = 300
     );
 
-    static void forward_byte_stream(
+    // Stream a request to backend and forward the raw response bytes (e.g. audio) to client.
+    // Returns true when the backend answered 200 and every byte reached the client.
+    static bool forward_byte_stream(
         const std::string& backend_url,
         const std::string& request_body,
         httplib::DataSink& sink,
         long timeout_seconds = 300
     );
 
+    // Seconds a client may stop reading before its stream is cancelled (0 = never)
+    static void set_stall_timeout(int seconds) { stall_timeout_seconds_ = seconds; }
+
+    // Stalled-client counters for /health, plus the number of streams being proxied
+    static json get_stats();
+
 private:
     // Parse telemetry from SSE chunks
     static TelemetryData parse_telemetry(const std::string& buffer);
+
+    // Write a backend chunk to the client, waiting up to the stall timeout while it is not
+    // reading. Returns false once the client is gone or has been dropped.
+    static bool write_to_client(httplib::DataSink& sink, const char* data, size_t length);
+
+    static std::atomic<int> stall_timeout_seconds_;
+    static std::atomic<int> stalled_clients_;
+    static std::atomic<uint64_t> stalled_clients_dropped_;
 };
 
 } // namespace lemon
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+namespace tracing {
+
+using json = nlohmann::json;
+
+// Lightweight request-scoped span tracing.
+//
+// Every HTTP request gets an id that lives in a thread_local for as long as the worker
+// handles it (including the streaming content provider, which runs on the same thread).
+// Spans opened on that thread are tagged with it and written into a fixed-size ring
+// buffer that overwrites the oldest entries; recording is a handful of atomics and a
+// memcpy, so tracing stays on permanently. Export as Chrome trace (chrome://tracing,
+// Perfetto) or OTLP-JSON through /api/v1/debug/trace.
+
+// Start tracing a request on this thread and return its id (0 = untraced request)
+uint64_t begin_request();
+
+// Record the enclosing "request" span and stop attributing spans on this thread to it
+void end_request(const std::string& detail = "");
+
+uint64_t current_request();
+
+// Attribute spans on this thread to a request (for helper threads working on its behalf;
+// 0 detaches). Does not record a "request" span.
+void set_current_request(uint64_t request_id);
+
+// Record a finished span for the current request (no-op when untraced)
+void record(const char* name,
+            std::chrono::system_clock::time_point start,
+            std::chrono::steady_clock::duration duration,
+            const std::string& detail = "");
+
+// RAII span: measures from construction to destruction or finish()
+class Span {
+public:
+    explicit Span(const char* name, std::string detail = "");
+    ~Span();
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    void set_detail(std::string detail) { detail_ = std::move(detail); }
+
+    // End the span early (e.g. at the first streamed byte)
+    void finish();
+
+private:
+    const char* name_;
+    std::string detail_;
+    std::chrono::system_clock::time_point wall_start_;
+    std::chrono::steady_clock::time_point start_;
+    bool finished_ = false;
+};
+
+// Export buffered spans, optionally only those of one request (request_id 0 = all)
+json export_chrome_trace(uint64_t request_id = 0);
+json export_otlp(uint64_t request_id = 0);
+
+} // namespace tracing
+} // namespace lemon
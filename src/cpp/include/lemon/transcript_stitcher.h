@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+/**
+ * Stitches interim transcriptions of a sliding audio window into a stable transcript.
+ *
+ * Each interim pass transcribes only the current window (the audio after the last trim
+ * point). A word is committed once two consecutive hypotheses agree on it (LocalAgreement-2),
+ * and committed words are never retracted. When committed text ends on a segment boundary
+ * the caller can move the window start there, freezing that text, so the audio sent to
+ * Whisper per update stays bounded instead of growing with the utterance.
+ */
+class TranscriptStitcher {
+public:
+    struct Word {
+        std::string text;
+        double end_s = -1.0;  // End time relative to the window start; -1 when not known exactly
+    };
+
+    /**
+     * Split a Whisper verbose_json response (or plain {"text": ...}) into words.
+     * Only words that end a segment carry an end time.
+     */
+    static std::vector<Word> words_from_response(const json& response);
+
+    /**
+     * Feed the hypothesis for the current window.
+     * @return Number of words newly committed
+     */
+    size_t update(const std::vector<Word>& hypothesis);
+
+    /**
+     * End of the last committed word with an exact timestamp (seconds from window start),
+     * or -1 if the window has no such word yet.
+     */
+    double committed_end_s() const;
+
+    /**
+     * The window start moved to committed_end_s(): freeze committed words up to that point.
+     */
+    void advance_window();
+
+    /**
+     * The window start moved to the end of the audio without a usable timestamp:
+     * freeze everything heard so far, including the tentative tail.
+     */
+    void flush_window();
+
+    // Committed text followed by the tentative (not yet agreed) tail
+    std::string text() const;
+
+    // Text of the audio before the window start
+    const std::string& frozen_text() const { return frozen_text_; }
+
+    // End of the frozen text, passed to Whisper as the prompt for the window's audio.
+    // Only text of audio before the window qualifies: the window is transcribed again.
+    std::string prompt(size_t max_chars = 200) const;
+
+    void reset();
+
+private:
+    static std::string normalize(const std::string& word);
+    static void append_words(std::string& out, const std::vector<Word>& words);
+
+    std::string frozen_text_;                // Text of audio before the window start
+    std::vector<Word> window_committed_;     // Committed words inside the window
+    std::vector<Word> tentative_;            // Uncommitted tail of the latest hypothesis
+};
+
+} // namespace lemon
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+// Fixed-size executor for realtime transcription jobs.
+//
+// Every realtime session produces an interim job about once a second plus a final job per
+// utterance, and all of them end up at the same whisper-server. Instead of a thread per job,
+// a fixed set of workers runs them with three rules:
+//  - Per session, jobs run one at a time and in submission order.
+//  - Per model, no more jobs run at once than the backend can serve (its replica count),
+//    so queued work waits here instead of piling up inside the backend.
+//  - Finals run before interims. Submitting a final drops the session's queued interims,
+//    whose results would be discarded anyway.
+class TranscriptionExecutor {
+public:
+    enum class Kind { Interim, Final };
+
+    // Concurrent jobs the backend serving a model can take (values below 1 count as 1).
+    // Called without the executor's lock held, so it may take other locks (e.g. the router's).
+    using CapacityFn = std::function<int(const std::string& model)>;
+
+    TranscriptionExecutor(size_t workers, CapacityFn capacity);
+    ~TranscriptionExecutor();
+
+    TranscriptionExecutor(const TranscriptionExecutor&) = delete;
+    TranscriptionExecutor& operator=(const TranscriptionExecutor&) = delete;
+
+    // Queue a job. `dropped` runs instead of `run` if the job is discarded before it starts
+    // (stale interim or shutdown). Returns false after shutdown (nothing is called).
+    bool submit(const std::string& session_id, const std::string& model, Kind kind,
+                std::function<void()> run, std::function<void()> dropped = nullptr);
+
+    // Drop a session's queued (not yet running) interim jobs
+    void drop_interim(const std::string& session_id);
+
+    // Drop every queued job and join the workers (running jobs finish first)
+    void shutdown();
+
+    // Queue depth, running jobs, wait times and drop counts
+    json get_stats() const;
+
+private:
+    struct Job {
+        std::string session_id;
+        std::string model;
+        Kind kind;
+        std::function<void()> run;
+        std::function<void()> dropped;
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    void worker_loop();
+
+    // Remove and return the next runnable job (caller must hold mutex_)
+    bool take_next(Job& job);
+
+    // Move a session's queued interims into `out` (caller must hold mutex_)
+    void collect_interim(const std::string& session_id, std::vector<Job>& out);
+
+    // Ask capacity_ for a model's current capacity and remember it (caller must NOT hold mutex_)
+    void refresh_capacity(const std::string& model);
+
+    CapacityFn capacity_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> queue_;
+    std::vector<std::thread> workers_;
+    std::unordered_set<std::string> running_sessions_;
+    std::unordered_map<std::string, int> running_models_;
+    std::unordered_map<std::string, int> model_capacity_;   // Last capacity_ answer per model
+    size_t running_ = 0;
+    size_t peak_queued_ = 0;
+    bool shutdown_ = false;
+
+    std::atomic<uint64_t> completed_interim_{0};
+    std::atomic<uint64_t> completed_final_{0};
+    std::atomic<uint64_t> dropped_stale_{0};
+    std::atomic<uint64_t> wait_ms_total_{0};
+    std::atomic<uint64_t> wait_ms_max_{0};
+};
+
+} // namespace lemon
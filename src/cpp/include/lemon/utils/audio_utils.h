@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+
+namespace lemon {
+namespace utils {
+
+/**
+ * Sample-rate converter (polyphase windowed sinc, Kaiser window).
+ *
+ * Converts between any two integer rates. Input can be fed in chunks, and the filter
+ * history carries over between calls, so it also works for streaming audio.
+ */
+class AudioResampler {
+public:
+    AudioResampler(int input_rate, int output_rate);
+
+    int input_rate() const { return input_rate_; }
+    int output_rate() const { return output_rate_; }
+
+    /**
+     * Resample a chunk, appending the converted samples to output.
+     * Output lags the input by half the filter length until flush().
+     */
+    void process(const float* input, size_t count, std::vector<float>& output);
+
+    /**
+     * Emit the samples still held back by the filter and reset for a new stream.
+     */
+    void flush(std::vector<float>& output);
+
+    /**
+     * Drop buffered input and start a new stream.
+     */
+    void reset();
+
+private:
+    int input_rate_;
+    int output_rate_;
+    size_t up_;                    // Interpolation factor (L)
+    size_t down_;                  // Decimation factor (M)
+    size_t taps_;                  // Filter taps per phase (multiple of 8)
+    std::vector<float> filters_;   // up_ phases x taps_ coefficients
+    std::vector<float> pending_;   // Input not yet fully consumed (starts with taps_/2 zeros)
+    uint64_t position_ = 0;        // Next output time relative to pending_[0], in 1/up_ input samples
+    uint64_t input_total_ = 0;     // Samples fed since the last reset
+    uint64_t output_total_ = 0;    // Samples produced since the last reset
+};
+
+/**
+ * Helpers for uncompressed audio.
+ */
+class AudioUtils {
+public:
+    static constexpr int WHISPER_SAMPLE_RATE = 16000;
+
+    struct WavInfo {
+        uint16_t format = 0;        // 1 = PCM, 3 = IEEE float
+        uint16_t channels = 0;
+        uint32_t sample_rate = 0;
+        uint16_t bits_per_sample = 0;
+        size_t data_offset = 0;
+        size_t data_size = 0;
+    };
+
+    /**
+     * Parse a RIFF/WAVE header (including WAVE_FORMAT_EXTENSIBLE).
+     * @return false if the data is not a WAV file with a supported sample encoding
+     */
+    static bool parse_wav(const std::string& data, WavInfo& info);
+
+    /**
+     * Convert a WAV upload to 16 kHz mono PCM16, the format whisper.cpp reads natively.
+     * Supports 8/16/24/32-bit PCM and 32/64-bit float at any rate and channel count.
+     * @param data WAV file bytes
+     * @param out Receives the converted WAV file
+     * @return true if data was converted; false if it is already 16 kHz mono PCM16 or
+     *         is not a WAV file this decoder understands (out is untouched)
+     */
+    static bool to_whisper_wav(const std::string& data, std::string& out);
+
+    /**
+     * Convert a float sample to PCM16: scaled by 32768, the inverse of decoding with
+     * s / 32768, and clipped to the int16 range.
+     */
+    static int16_t to_pcm16(float sample) {
+        float scaled = (std::max)(-32768.0f, (std::min)(32767.0f, sample * 32768.0f));
+        return static_cast<int16_t>(std::lround(scaled));
+    }
+
+    /**
+     * Build a PCM16 mono WAV file from float samples in [-1, 1] (clipped).
+     */
+    static std::string encode_wav(const std::vector<float>& samples, int sample_rate);
+
+    /**
+     * Build a PCM16 mono WAV file from int16 samples.
+     */
+    static std::string encode_wav(const int16_t* samples, size_t count, int sample_rate);
+};
+
+} // namespace utils
+} // namespace lemon
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace lemon {
+namespace utils {
+
+// 64-bit FNV-1a. Not cryptographic, but stable across builds and platforms, so it can key
+// files and ETags that must survive a restart.
+uint64_t fnv1a_64(const std::string& data);
+
+// fnv1a_64 as 16 lowercase hex digits
+std::string fnv1a_64_hex(const std::string& data);
+
+} // namespace utils
+} // namespace lemon
@@ -6,6 +6,7 @@
 #include <functional>
 #include <chrono>
 #include <memory>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
 
@@ -23,6 +24,7 @@ struct MultipartField {
     std::string data;
     std::string filename;       // empty for text fields
     std::string content_type;   // empty for text fields
+    std::shared_ptr<const std::string> shared_data;  // sent instead of data, without a copy
 };
 
 // Result of a download operation with detailed error information
@@ -64,6 +66,11 @@ public:
         return default_timeout_seconds_;
     }
 
+    // Number of post_stream() requests currently in flight
+    static int get_active_streams() {
+        return active_streams_;
+    }
+
     // Simple GET request
     static HttpResponse get(const std::string& url,
                            const std::map<std::string, std::string>& headers = {});
@@ -98,6 +105,7 @@ public:
 
 private:
     static long default_timeout_seconds_;
+    static std::atomic<int> active_streams_;
 
     // Single download attempt, may resume from offset
     static DownloadResult download_attempt(const std::string& url,
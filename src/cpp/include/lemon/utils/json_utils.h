@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 namespace lemon {
@@ -37,6 +38,23 @@ public:
         return default_value;
     }
 
+    // Read top-level scalar fields of a serialized JSON object without building a DOM.
+    // Scanning stops as soon as every requested key has been seen, so routing fields near
+    // the start of a large request are found without reading the rest of it. Keys that are
+    // missing (or hold an object/array) are absent from the result.
+    static json scan_fields(const std::string& json_str, const std::vector<std::string>& keys);
+
+    // OpenAI deprecated max_tokens in favor of max_completion_tokens (Sep 2024) but llama.cpp
+    // only supports the older name: true when a request has to get max_tokens added
+    static bool needs_max_tokens(const json& request) {
+        return request.contains("max_completion_tokens") && !request.contains("max_tokens");
+    }
+
+    // Add a top-level field to a serialized JSON object in place, leaving the rest of the
+    // bytes untouched. The caller must know the key is not already present.
+    // Returns false if json_str is not an object.
+    static bool insert_field(std::string& json_str, const std::string& key, const json& value);
+
     // Encode binary data to base64 string
     static std::string base64_encode(const std::string& input);
 
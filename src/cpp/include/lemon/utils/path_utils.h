@@ -92,6 +92,32 @@ std::string get_hf_cache_dir();
  */
 std::string get_runtime_dir();
 
+/**
+ * Path of the router's Unix domain socket for a port.
+ * @param setting "auto" or empty for <runtime dir>/lemonade-<port>.sock, "off" to disable,
+ *                or an explicit socket path (the value of --unix-socket / LEMONADE_UNIX_SOCKET).
+ *                Without XDG_RUNTIME_DIR, "auto" uses a private /tmp/lemonade-<uid> directory
+ *                (mode 0700) rather than /tmp itself.
+ * @return Socket path, or empty string when disabled, unsafe, or on Windows.
+ */
+std::string get_unix_socket_path(int port, const std::string& setting = "auto");
+
+/**
+ * Check whether a server is accepting connections on a Unix domain socket.
+ * Used by local clients to prefer the socket over TCP loopback, and by the router to
+ * tell a stale socket file from one owned by a running instance.
+ */
+bool is_unix_socket_listening(const std::string& path);
+
+/**
+ * Find the Unix socket of a router on this machine, honoring LEMONADE_UNIX_SOCKET.
+ * @param host Host the client would otherwise connect to; only loopback/bind-all hosts qualify.
+ * Only sockets owned by the current user or root are used. The listening probe is cached
+ * for a few seconds per socket file, so clients can call this for every connection.
+ * @return Socket path when a router is listening on it, otherwise empty (use TCP).
+ */
+std::string find_router_unix_socket(const std::string& host, int port);
+
 /**
  * Get the directory where backend executables will be downloaded.
  * This is in the user's cache directory (~/.cache/lemonade/bin on all platforms)
@@ -2,42 +2,36 @@
 
 #include <vector>
 #include <chrono>
+#include <cstdint>
+#include "streaming_audio_buffer.h"
 
 namespace lemon {
 
 /**
- * Simple energy-based Voice Activity Detection.
- * Detects speech start/end events based on audio energy levels.
+ * Voice Activity Detection engine interface.
+ * Engines watch a session's audio buffer and report speech start/end events;
+ * the engine is chosen per session with turn_detection.type.
  */
-class SimpleVAD {
+class VoiceActivityDetector {
 public:
-    struct Config {
-        float energy_threshold = 0.01f;     // RMS threshold for speech detection
-        float freq_threshold = 100.0f;      // Minimum frequency for speech (unused for now)
-        int min_speech_ms = 250;            // Minimum speech duration to trigger
-        int min_silence_ms = 800;           // Silence duration to end speech (longer = bigger chunks for Whisper)
-        int sample_rate = 16000;            // Audio sample rate
-        int onset_frames = 2;              // Consecutive voice frames required to confirm speech start
-        int hangover_frames = 6;           // Extra frames (~510ms) to continue after silence before ending speech
-    };
-
     enum class Event {
         None,           // No event
         SpeechStart,    // Speech started
         SpeechEnd       // Speech ended (trigger transcription)
     };
 
-    SimpleVAD();
-    explicit SimpleVAD(const Config& config);
-    ~SimpleVAD() = default;
+    virtual ~VoiceActivityDetector() = default;
 
     /**
-     * Process an audio chunk and detect speech events.
-     * @param audio Float32 audio samples normalized to [-1.0, 1.0]
-     * @param sample_rate Sample rate of the audio (should match config)
+     * Examine the audio appended to the buffer since the previous call.
      * @return Event type if a speech boundary was detected
      */
-    Event process(const std::vector<float>& audio, int sample_rate);
+    virtual Event process(const StreamingAudioBuffer& buffer) = 0;
+
+    /**
+     * Reset the VAD state (call whenever the buffer is cleared).
+     */
+    virtual void reset();
 
     /**
      * Check if speech is currently active.
@@ -54,10 +48,58 @@ public:
      */
     int64_t speech_end_ms() const { return speech_end_ms_; }
 
+    /**
+     * RMS level of the most recently processed audio (for logging and threshold tuning).
+     */
+    float last_rms() const { return last_rms_; }
+
+protected:
+    bool speech_active_ = false;
+    int64_t speech_start_ms_ = 0;
+    int64_t speech_end_ms_ = 0;
+    float last_rms_ = 0.0f;
+
+    // Get current time in milliseconds
+    static int64_t current_time_ms();
+};
+
+/**
+ * Simple energy-based Voice Activity Detection.
+ * Detects speech start/end events based on audio energy levels.
+ */
+class SimpleVAD : public VoiceActivityDetector {
+public:
+    struct Config {
+        float energy_threshold = 0.01f;     // RMS threshold for speech detection
+        float freq_threshold = 100.0f;      // Minimum frequency for speech (unused for now)
+        int min_speech_ms = 250;            // Minimum speech duration to trigger
+        int min_silence_ms = 800;           // Silence duration to end speech (longer = bigger chunks for Whisper)
+        int sample_rate = 16000;            // Audio sample rate
+        int onset_frames = 2;              // Consecutive voice frames required to confirm speech start
+        int hangover_frames = 6;           // Extra frames (~510ms) to continue after silence before ending speech
+    };
+
+    SimpleVAD();
+    explicit SimpleVAD(const Config& config);
+    ~SimpleVAD() override = default;
+
+    /**
+     * Process the most recent 100ms of the buffer as one frame.
+     */
+    Event process(const StreamingAudioBuffer& buffer) override;
+
+    /**
+     * Process an audio chunk and detect speech events.
+     * @param audio Float32 audio samples normalized to [-1.0, 1.0]
+     * @param sample_rate Sample rate of the audio (should match config)
+     * @return Event type if a speech boundary was detected
+     */
+    Event process(const std::vector<float>& audio, int sample_rate);
+
     /**
      * Reset the VAD state.
      */
-    void reset();
+    void reset() override;
 
     /**
      * Update configuration.
@@ -66,19 +108,83 @@ public:
 
 private:
     Config config_;
-    bool speech_active_ = false;
-    int64_t speech_start_ms_ = 0;
-    int64_t speech_end_ms_ = 0;
     int speech_frames_ = 0;      // Consecutive frames with speech
     int silence_frames_ = 0;     // Consecutive frames without speech
     int onset_counter_ = 0;      // Consecutive voice frames during onset confirmation
     int hangover_counter_ = 0;   // Remaining hangover frames before speech end
+    std::vector<float> recent_;  // Reused per call to avoid allocating
 
     // Calculate RMS energy of audio chunk
     static float calculate_rms(const std::vector<float>& audio);
+};
 
-    // Get current time in milliseconds
-    static int64_t current_time_ms();
+/**
+ * Frame-based spectral Voice Activity Detection.
+ *
+ * Every sample is examined in short frames (20ms by default). A frame counts as voiced
+ * when its log energy is well above an adaptive noise floor and its spectrum is peaky
+ * (low spectral flatness), which rejects fans, hum and other stationary noise that an
+ * RMS threshold lets through. Loud, high zero-crossing frames (fricatives such as "s")
+ * keep an utterance going but cannot start one. Decisions are made per frame, so the end
+ * of speech is detected with frame rather than chunk granularity.
+ */
+class SpectralVAD : public VoiceActivityDetector {
+public:
+    struct Config {
+        int frame_ms = 20;                  // Analysis frame length (10-30ms)
+        float snr_threshold_db = 9.0f;      // Frame energy above the noise floor to count as speech
+        float flatness_threshold = 0.35f;   // Max spectral flatness (0 = tonal, 1 = white noise) for voiced frames
+        float fricative_zcr = 0.3f;         // Min zero-crossing rate for an unvoiced speech frame
+        int min_speech_ms = 200;            // Voiced audio required to confirm speech start
+        int min_silence_ms = 600;           // Silence required to end speech
+        float noise_rise_rate = 0.02f;      // How fast the noise floor follows louder non-speech frames
+        int sample_rate = 16000;            // Audio sample rate
+    };
+
+    SpectralVAD();
+    explicit SpectralVAD(const Config& config);
+    ~SpectralVAD() override = default;
+
+    /**
+     * Process every sample appended since the previous call, frame by frame.
+     * Stops at the first speech boundary; remaining audio is examined on the next call.
+     */
+    Event process(const StreamingAudioBuffer& buffer) override;
+
+    void reset() override;
+
+    void set_config(const Config& config);
+
+private:
+    struct Features {
+        float log_energy_db;
+        float flatness;
+        float zcr;
+    };
+
+    Features analyze_frame(const float* frame);
+    Event process_frame(const float* frame);
+
+    Config config_;
+    size_t frame_size_ = 320;
+    size_t position_ = 0;                // Buffer samples already examined
+    std::vector<float> pending_;         // Samples of an incomplete frame
+    std::vector<float> fresh_;           // Newly appended samples (reused per call)
+
+    float noise_floor_db_ = 0.0f;
+    bool noise_initialized_ = false;
+    int voiced_ms_ = 0;                  // Voiced audio during onset
+    int silence_ms_ = 0;                 // Silence during speech
+
+    // FFT of the frame zero-padded to a power of two
+    static void fft(std::vector<float>& re, std::vector<float>& im,
+                    const std::vector<float>& twiddle_re, const std::vector<float>& twiddle_im);
+
+    std::vector<float> window_;          // Hann window
+    std::vector<float> twiddle_re_;
+    std::vector<float> twiddle_im_;
+    std::vector<float> re_;
+    std::vector<float> im_;
 };
 
 } // namespace lemon
@@ -54,6 +54,11 @@ public:
      */
     int get_port() const { return port_; }
 
+    /**
+     * Realtime session and transcription queue metrics.
+     */
+    json get_stats() const { return session_manager_->get_stats(); }
+
 private:
     int port_;
     Router* router_;
@@ -73,6 +78,9 @@ private:
     // Handle incoming WebSocket message
     void handle_message(const std::string& connection_id, const std::string& msg);
 
+    // Handle incoming binary WebSocket message (raw PCM16 audio for the session)
+    void handle_binary_message(const std::string& connection_id, const std::string& data);
+
     // Handle WebSocket connection close
     void handle_close(const std::string& connection_id);
 
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <nlohmann/json.hpp>
+#include <httplib.h>
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+// Elastic worker pool for the HTTP servers.
+//
+// httplib hands each accepted connection to its task queue before the request is read, so
+// a streaming chat completion and a /health probe look the same at dispatch time, and a
+// stream then holds its worker for the whole generation. Instead of a fixed pool, this one
+// keeps min_threads workers around for short control-plane requests and spawns extra
+// workers (up to max_threads) whenever a connection arrives and nobody is idle, so
+// long-lived streams, downloads and log tails never starve health checks. Extra workers
+// exit after sitting idle for a while.
+class WorkerPool {
+public:
+    WorkerPool(size_t min_threads, size_t max_threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    bool enqueue(std::function<void()> fn);
+
+    // Stop accepting work, finish queued jobs and join every worker
+    void shutdown();
+
+    // Saturation metrics: thread counts, busy/queued jobs, and how often work had to wait,
+    // plus connection reuse for jobs submitted through Queue
+    json get_stats() const;
+
+    // Count a request on the connection the calling worker is serving (no-op outside Queue jobs)
+    static void note_request();
+
+    // Adapter handed to httplib::Server::new_task_queue (httplib owns and deletes it).
+    // httplib submits one job per accepted connection that serves all of its keep-alive
+    // requests, so jobs run through here are tracked as connections.
+    class Queue : public httplib::TaskQueue {
+    public:
+        explicit Queue(std::shared_ptr<WorkerPool> pool) : pool_(std::move(pool)) {}
+        bool enqueue(std::function<void()> fn) override;
+        void shutdown() override { pool_->shutdown(); }
+
+    private:
+        std::shared_ptr<WorkerPool> pool_;
+    };
+
+private:
+    void spawn_worker();   // Caller must hold mutex_
+    void reap_finished();  // Caller must hold mutex_
+    void worker_loop();
+    void serve_connection(const std::function<void()>& fn);
+
+    const size_t min_threads_;
+    const size_t max_threads_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    std::list<std::thread> workers_;
+    std::list<std::thread::id> finished_;  // Workers that exited and can be joined
+    size_t threads_ = 0;
+    size_t idle_ = 0;
+    size_t peak_threads_ = 0;
+    bool shutdown_ = false;
+
+    std::atomic<uint64_t> jobs_total_{0};
+    std::atomic<uint64_t> jobs_queued_at_max_{0};  // Jobs that waited because every worker was busy
+
+    // Connection metrics (Queue jobs only)
+    std::atomic<uint64_t> connections_accepted_{0};
+    std::atomic<uint64_t> connections_active_{0};   // Open connections, i.e. live keep-alive sockets
+    std::atomic<uint64_t> connections_closed_{0};
+    std::atomic<uint64_t> connection_requests_{0};  // Requests served on closed connections
+    std::atomic<uint64_t> max_requests_per_connection_{0};
+};
+
+} // namespace lemon
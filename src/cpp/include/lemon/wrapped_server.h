@@ -5,6 +5,8 @@
 #include <functional>
 #include <chrono>
 #include <mutex>
+#include <condition_variable>
+#include <algorithm>
 #include <nlohmann/json.hpp>
 #include <httplib.h>
 #include "utils/process_manager.h"
@@ -26,6 +28,8 @@ struct Telemetry {
     double tokens_per_second = 0.0;
     std::vector<double> decode_token_times;
     int prompt_tokens = 0;  // From usage.prompt_tokens (includes cached tokens)
+    int draft_tokens = 0;           // Speculative decoding: tokens proposed by the draft model
+    int draft_tokens_accepted = 0;  // Speculative decoding: proposals accepted by the main model
 
     void reset() {
         input_tokens = 0;
@@ -34,6 +38,8 @@ struct Telemetry {
         tokens_per_second = 0.0;
         decode_token_times.clear();
         prompt_tokens = 0;
+        draft_tokens = 0;
+        draft_tokens_accepted = 0;
     }
 
     json to_json() const {
@@ -43,7 +49,10 @@ struct Telemetry {
             {"time_to_first_token", time_to_first_token},
             {"tokens_per_second", tokens_per_second},
             {"decode_token_times", decode_token_times},
-            {"prompt_tokens", prompt_tokens}
+            {"prompt_tokens", prompt_tokens},
+            {"draft_tokens", draft_tokens},
+            {"draft_tokens_accepted", draft_tokens_accepted},
+            {"draft_acceptance_rate", draft_tokens > 0 ? (double) draft_tokens_accepted / draft_tokens : 0.0}
         };
     }
 };
@@ -55,7 +64,8 @@ public:
         : server_name_(server_name), port_(0), process_handle_({nullptr, 0}), log_level_(log_level),
           model_manager_(model_manager), backend_manager_(backend_manager),
           last_access_time_(std::chrono::steady_clock::now()),
-          is_busy_(false) {}
+          last_release_time_(last_access_time_),
+          active_requests_(0) {}
 
     virtual ~WrappedServer() = default;
 
@@ -75,23 +85,46 @@ public:
         return last_access_time_;
     }
 
-    // Multi-model support: Track if server is currently processing a request
+    // Multi-model support: Track in-flight requests (for safe eviction and replica balancing)
     void set_busy(bool busy) {
         std::lock_guard<std::mutex> lock(busy_mutex_);
-        is_busy_ = busy;
-        if (!busy) {
+        if (busy) {
+            active_requests_++;
+        } else if (active_requests_ > 0) {
+            active_requests_--;
+            last_release_time_ = std::chrono::steady_clock::now();
+        }
+        if (active_requests_ == 0) {
             busy_cv_.notify_all();
         }
     }
 
     bool is_busy() const {
         std::lock_guard<std::mutex> lock(busy_mutex_);
-        return is_busy_;
+        return active_requests_ > 0;
+    }
+
+    int get_active_requests() const {
+        std::lock_guard<std::mutex> lock(busy_mutex_);
+        return active_requests_;
+    }
+
+    // Idle unload: time since the server last started or finished a request
+    std::chrono::steady_clock::duration get_idle_duration() const {
+        std::lock_guard<std::mutex> lock(busy_mutex_);
+        if (active_requests_ > 0) {
+            return std::chrono::steady_clock::duration::zero();
+        }
+        return std::chrono::steady_clock::now() - std::max(last_access_time_, last_release_time_);
     }
 
+    // Idle unload: seconds of inactivity before the router unloads this server (-1 = never)
+    void set_keep_alive(int seconds) { keep_alive_seconds_ = seconds; }
+    int get_keep_alive() const { return keep_alive_seconds_; }
+
     void wait_until_not_busy() const {
         std::unique_lock<std::mutex> lock(busy_mutex_);
-        while (is_busy_) {
+        while (active_requests_ > 0) {
             busy_cv_.wait(lock);
         }
     }
@@ -112,6 +145,15 @@ public:
     DeviceType get_device_type() const { return device_type_; }
     RecipeOptions get_recipe_options() const { return recipe_options_; }
 
+    // Replica support: position of this instance among the processes serving one model
+    void set_replica(int index, int count) {
+        replica_index_ = index;
+        replica_count_ = count;
+    }
+
+    int get_replica_index() const { return replica_index_; }
+    int get_replica_count() const { return replica_count_; }
+
     // Load a model and start the server
     virtual void load(const std::string& model_name,
                      const ModelInfo& model_info,
@@ -134,6 +176,13 @@ public:
                                            bool sse = true,
                                            long timeout_seconds = 0);
 
+    // Forward a request whose response is raw bytes (e.g. audio). Returns true when the
+    // backend answered 200 and the whole response reached the client.
+    bool forward_byte_stream(const std::string& endpoint,
+                             const std::string& request_body,
+                             httplib::DataSink& sink,
+                             long timeout_seconds = 0);
+
     // Get the server address
     std::string get_address() const {
         return get_base_url() + "/v1";
@@ -156,6 +205,12 @@ public:
         telemetry_.prompt_tokens = prompt_tokens;
     }
 
+    // Set speculative decoding counters from timings
+    void set_draft_telemetry(int draft_tokens, int draft_tokens_accepted) {
+        telemetry_.draft_tokens = draft_tokens;
+        telemetry_.draft_tokens_accepted = draft_tokens_accepted;
+    }
+
 protected:
     // Choose an available port
     int choose_port();
@@ -194,11 +249,15 @@ protected:
     DeviceType device_type_ = DEVICE_NONE;
     std::chrono::steady_clock::time_point last_access_time_;
     RecipeOptions recipe_options_;
+    int replica_index_ = 0;
+    int replica_count_ = 1;
+    int keep_alive_seconds_ = -1;
 
     // Busy state tracking (for safe eviction)
     mutable std::mutex busy_mutex_;
     mutable std::condition_variable busy_cv_;
-    bool is_busy_;
+    std::chrono::steady_clock::time_point last_release_time_;
+    int active_requests_;
 };
 
 } // namespace lemon
@@ -334,7 +334,9 @@ json OllamaApi::convert_anthropic_to_openai_chat(const json& anthropic_request,
     openai_req["messages"] = messages;
 
     if (anthropic_request.contains("max_tokens")) {
+        // llama.cpp only reads the older max_tokens name
         openai_req["max_completion_tokens"] = anthropic_request["max_tokens"];
+        openai_req["max_tokens"] = anthropic_request["max_tokens"];
     }
     if (anthropic_request.contains("temperature")) {
         openai_req["temperature"] = anthropic_request["temperature"];
@@ -917,6 +919,7 @@ void OllamaApi::handle_anthropic_messages(const httplib::Request& req, httplib::
         if (stream) {
             openai_req["stream"] = true;
             std::string openai_body = openai_req.dump();
+            std::string routed_model = openai_req.value("model", "");
 
             res.set_header("Content-Type", "text/event-stream");
             res.set_header("Cache-Control", "no-cache");
@@ -925,12 +928,12 @@ void OllamaApi::handle_anthropic_messages(const httplib::Request& req, httplib::
 
             res.set_chunked_content_provider(
                 "text/event-stream",
-                [this, openai_body, model, warnings](size_t offset, httplib::DataSink& sink) {
+                [this, openai_body, model, routed_model, warnings](size_t offset, httplib::DataSink& sink) {
                     if (offset > 0) return false;
 
                     stream_openai_sse_to_anthropic_sse(openai_body, sink, model, warnings,
-                        [this](const std::string& body, httplib::DataSink& s) {
-                            router_->chat_completion_stream(body, s);
+                        [this, &routed_model](const std::string& body, httplib::DataSink& s) {
+                            router_->chat_completion_stream(routed_model, body, s);
                         }
                     );
 
@@ -0,0 +1,191 @@
+#include "lemon/audio_chunking.h"
+#include "lemon/audio_types.h"
+#include "lemon/utils/audio_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace lemon {
+namespace audio {
+
+bool chunking_requested(const json& request) {
+    if (!request.contains("chunking_strategy")) {
+        return false;
+    }
+
+    const auto& strategy = request["chunking_strategy"];
+    if (strategy.is_string()) {
+        return strategy.get<std::string>() == "auto";
+    }
+    return strategy.is_object() && strategy.value("type", "") == "server_vad";
+}
+
+std::vector<AudioChunk> split_at_silences(const std::string& wav) {
+    using utils::AudioUtils;
+
+    AudioUtils::WavInfo info;
+    if (!AudioUtils::parse_wav(wav, info) || info.format != 1 || info.bits_per_sample != 16 ||
+        info.channels != 1 || info.sample_rate != AudioUtils::WHISPER_SAMPLE_RATE) {
+        return {};
+    }
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(wav.data()) + info.data_offset;
+    const size_t total = info.data_size / 2;
+    const int rate = AudioUtils::WHISPER_SAMPLE_RATE;
+    std::vector<int16_t> samples(total);
+    for (size_t i = 0; i < total; i++) {
+        samples[i] = static_cast<int16_t>(bytes[i * 2] | (bytes[i * 2 + 1] << 8));
+    }
+
+    std::vector<std::pair<size_t, size_t>> ranges;
+    if (total < static_cast<size_t>(Chunking::MIN_AUDIO_SECONDS * rate)) {
+        ranges.emplace_back(0, total);
+    } else {
+        // Energy of 20ms frames, smoothed over 200ms so a cut lands in a pause rather than
+        // between two syllables
+        const size_t frame = rate / 50;
+        const size_t frames = total / frame;
+        std::vector<double> energy(frames, 0.0);
+        for (size_t f = 0; f < frames; f++) {
+            double sum = 0.0;
+            for (size_t i = f * frame; i < (f + 1) * frame; i++) {
+                sum += static_cast<double>(samples[i]) * samples[i];
+            }
+            energy[f] = sum / frame;
+        }
+        const size_t smooth = 10;
+        std::vector<double> smoothed(frames, 0.0);
+        double window = 0.0;
+        for (size_t f = 0; f < frames; f++) {
+            window += energy[f];
+            if (f >= smooth) window -= energy[f - smooth];
+            smoothed[f] = window;  // Covers frames (f - smooth, f]
+        }
+
+        const size_t target = static_cast<size_t>(Chunking::TARGET_SECONDS * rate / frame);
+        const size_t search = static_cast<size_t>(Chunking::SEARCH_SECONDS * rate / frame);
+        size_t start_frame = 0;
+        while (frames - start_frame > target + search) {
+            size_t lo = start_frame + target - search;
+            size_t hi = start_frame + target + search;
+            size_t best = lo;
+            for (size_t f = lo; f <= hi; f++) {
+                if (smoothed[f] < smoothed[best]) best = f;
+            }
+            // Cut in the middle of the quiet 200ms
+            size_t cut_frame = best - smooth / 2 + 1;
+            ranges.emplace_back(start_frame * frame, cut_frame * frame);
+            start_frame = cut_frame;
+        }
+        ranges.emplace_back(start_frame * frame, total);
+    }
+
+    std::vector<AudioChunk> chunks;
+    chunks.reserve(ranges.size());
+    for (const auto& range : ranges) {
+        AudioChunk chunk;
+        chunk.wav = AudioUtils::encode_wav(samples.data() + range.first, range.second - range.first, rate);
+        chunk.offset_s = static_cast<double>(range.first) / rate;
+        chunk.duration_s = static_cast<double>(range.second - range.first) / rate;
+        chunks.push_back(std::move(chunk));
+    }
+    return chunks;
+}
+
+// "HH:MM:SS,mmm" (SRT) or "HH:MM:SS.mmm" (VTT)
+static std::string format_timestamp(double seconds, char separator) {
+    long long ms = std::llround(std::max(0.0, seconds) * 1000.0);
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%02lld:%02lld:%02lld%c%03lld",
+                  ms / 3600000, (ms / 60000) % 60, (ms / 1000) % 60, separator, ms % 1000);
+    return buf;
+}
+
+static void shift_times(json& item, double offset) {
+    for (const char* key : {"start", "end"}) {
+        if (item.contains(key) && item[key].is_number()) {
+            item[key] = item[key].get<double>() + offset;
+        }
+    }
+}
+
+static void append_text(std::string& text, const std::string& piece) {
+    size_t begin = piece.find_first_not_of(" \n");
+    if (begin == std::string::npos) {
+        return;
+    }
+    size_t end = piece.find_last_not_of(" \n");
+    if (!text.empty()) {
+        text += ' ';
+    }
+    text += piece.substr(begin, end - begin + 1);
+}
+
+json stitch_transcriptions(const std::vector<json>& responses,
+                           const std::vector<AudioChunk>& chunks,
+                           const std::string& response_format) {
+    std::string text;
+    json segments = json::array();
+    std::string language;
+
+    for (size_t i = 0; i < responses.size() && i < chunks.size(); i++) {
+        const json& response = responses[i];
+        if (response.contains("text") && response["text"].is_string()) {
+            append_text(text, response["text"].get<std::string>());
+        }
+        if (language.empty() && response.contains("language") && response["language"].is_string()) {
+            language = response["language"].get<std::string>();
+        }
+        if (!response.contains("segments") || !response["segments"].is_array()) {
+            continue;
+        }
+        for (json segment : response["segments"]) {
+            shift_times(segment, chunks[i].offset_s);
+            if (segment.contains("words") && segment["words"].is_array()) {
+                for (auto& word : segment["words"]) {
+                    shift_times(word, chunks[i].offset_s);
+                }
+            }
+            segment["id"] = segments.size();
+            segments.push_back(std::move(segment));
+        }
+    }
+
+    double duration = chunks.empty() ? 0.0 : chunks.back().offset_s + chunks.back().duration_s;
+
+    if (response_format == ResponseFormat::VERBOSE_JSON) {
+        json result = {
+            {"task", "transcribe"},
+            {"duration", duration},
+            {"text", text},
+            {"segments", segments}
+        };
+        if (!language.empty()) {
+            result["language"] = language;
+        }
+        return result;
+    }
+
+    if (response_format == ResponseFormat::SRT || response_format == ResponseFormat::VTT) {
+        bool srt = response_format == ResponseFormat::SRT;
+        std::string out = srt ? "" : "WEBVTT\n\n";
+        size_t index = 1;
+        for (const auto& segment : segments) {
+            std::string segment_text;
+            append_text(segment_text, segment.value("text", ""));
+            if (srt) {
+                out += std::to_string(index++) + "\n";
+            }
+            out += format_timestamp(segment.value("start", 0.0), srt ? ',' : '.') + " --> " +
+                   format_timestamp(segment.value("end", 0.0), srt ? ',' : '.') + "\n" +
+                   segment_text + "\n\n";
+        }
+        return json{{"text", out}};
+    }
+
+    // json and text
+    return json{{"text", text}};
+}
+
+} // namespace audio
+} // namespace lemon
@@ -322,7 +322,7 @@ json FastFlowLMServer::reranking(const json& request) {
     return forward_request("/v1/rerank", request);
 }
 
-json FastFlowLMServer::audio_transcriptions(const json& request) {
+json FastFlowLMServer::audio_transcriptions(const json& request, const audio::AudioPayload& audio) {
     if (model_type_ != ModelType::AUDIO) {
         return ErrorResponse::from_exception(
             UnsupportedOperationException("Audio transcription", "FLM " + model_type_to_string(model_type_) + " model")
@@ -330,16 +330,12 @@ json FastFlowLMServer::audio_transcriptions(const json& request) {
     }
 
     try {
-        // Extract audio data from request (same format as WhisperServer)
-        if (!request.contains("file_data")) {
-            throw std::runtime_error("Missing 'file_data' in request");
+        if (audio.empty()) {
+            throw std::runtime_error("Empty audio data");
         }
 
-        std::string audio_data = request["file_data"].get<std::string>();
-        std::string filename = request.value("filename", "audio.wav");
-
         // Determine content type from filename extension
-        std::filesystem::path filepath(filename);
+        std::filesystem::path filepath(audio.filename);
         std::string ext = filepath.extension().string();
         std::string content_type = "audio/wav";
         if (ext == ".mp3") content_type = "audio/mpeg";
@@ -351,12 +347,13 @@ json FastFlowLMServer::audio_transcriptions(const json& request) {
         // Build multipart fields for FLM's /v1/audio/transcriptions endpoint
         std::vector<utils::MultipartField> fields;
 
-        // Audio file field
+        // Audio file field, sent from the shared buffer
         fields.push_back({
             "file",
-            audio_data,
+            "",
             filepath.filename().string(),
-            content_type
+            content_type,
+            audio.data
         });
 
         // Model field (required by OpenAI API format)
@@ -168,7 +168,7 @@ json KokoroServer::responses(const json& request) {
     };
 }
 
-void KokoroServer::audio_speech(const json& request, httplib::DataSink& sink) {
+bool KokoroServer::audio_speech(const json& request, httplib::DataSink& sink) {
     json tts_request = request;
     tts_request["model"] = "kokoro";
 
@@ -178,7 +178,7 @@ void KokoroServer::audio_speech(const json& request, httplib::DataSink& sink) {
         tts_request["stream"] = true;
     }
 
-    forward_streaming_request("/v1/audio/speech", tts_request.dump(), sink, false);
+    return forward_byte_stream("/v1/audio/speech", tts_request.dump(), sink);
 }
 
 } // namespace backends
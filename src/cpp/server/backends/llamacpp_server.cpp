@@ -5,11 +5,17 @@
 #include "lemon/utils/process_manager.h"
 #include "lemon/error_types.h"
 #include "lemon/system_info.h"
+#include "lemon/utils/path_utils.h"
+#include "lemon/utils/json_utils.h"
+#include "lemon/utils/hash_utils.h"
 #include <iostream>
 #include <filesystem>
 #include <lemon/utils/aixlog.hpp>
 #include <cstdlib>
 #include <set>
+#include <thread>
+#include <algorithm>
+#include <cctype>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -32,6 +38,49 @@ static const int EMBEDDING_CTX_SIZE = 8192;
 static const int EMBEDDING_BATCH_SIZE = 8192;
 static const int EMBEDDING_UBATCH_SIZE = 8192;
 
+// Maximum number of saved slot files kept per model (each can be hundreds of MB at long context)
+static const size_t MAX_SAVED_SLOTS = 16;
+
+// Key identifying a conversation. Clients that know their conversation pass its id as
+// prompt_cache_key (OpenAI's prompt caching hint). Otherwise the key covers everything up to
+// and including the first user turn: later turns of the same chat share this prefix, so the
+// saved slot is always a usable prompt-cache prefix for them. Uses FNV-1a so keys are stable
+// across builds.
+static std::string get_conversation_key(const std::string& model_name, const json& request) {
+    if (request.contains("prompt_cache_key") && request["prompt_cache_key"].is_string() &&
+        !request["prompt_cache_key"].get_ref<const std::string&>().empty()) {
+        return fnv1a_64_hex(model_name + "\nid:" + request["prompt_cache_key"].get<std::string>());
+    }
+
+    if (!request.contains("messages") || !request["messages"].is_array()) {
+        return "";
+    }
+
+    json prefix = json::array();
+    for (const auto& message : request["messages"]) {
+        prefix.push_back(message);
+        if (message.value("role", "") == "user") {
+            break;
+        }
+    }
+
+    return fnv1a_64_hex(model_name + "\n" + prefix.dump());
+}
+
+// Model names may contain '/', ':' or other characters that are not valid in a path segment
+static std::string sanitize_dir_name(const std::string& name) {
+    std::string result = name;
+    for (char& c : result) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_' && c != '.') {
+            c = '_';
+        }
+    }
+    if (result.find_first_not_of('.') == std::string::npos) {
+        result = "_" + result;  // "", "." and ".." are not directories of their own
+    }
+    return result;
+}
+
 // Helper to push reserved flags and their aliases
 static void push_reserved(std::set<std::string>& reserved,
                     const std::string& key,
@@ -255,6 +304,86 @@ void LlamaCppServer::load(const std::string& model_name,
     LOG(DEBUG, "LlamaCpp") << "ngl set to " << gpu_layers << std::endl;
     push_arg(args, reserved_flags, "-ngl", gpu_layers, std::vector<std::string>{"--gpu-layers", "--n-gpu-layers"});
 
+    // Speculative decoding: resolve the draft model through the registry, downloading it if needed.
+    // The registry's pairing is only a default: it is skipped on CPU, where verifying draft
+    // tokens costs as much as generating them, and a failure loads the model without it.
+    // A draft the user asked for explicitly must work.
+    std::string draft_model = options.get_option("draft_model");
+    bool registry_draft = !draft_model.empty() && draft_model == model_info.draft_model;
+    if (!draft_model.empty() && draft_model != "none") {
+        if (model_info.type != ModelType::LLM) {
+            LOG(DEBUG, "LlamaCpp") << "Ignoring draft model for non-LLM model" << std::endl;
+        } else if (!mmproj_path.empty()) {
+            LOG(WARNING, "LlamaCpp") << "Draft model " << draft_model
+                                     << " ignored: speculative decoding is not supported with vision models" << std::endl;
+        } else if (registry_draft && !use_gpu) {
+            LOG(DEBUG, "LlamaCpp") << "Skipping default draft model " << draft_model << " on CPU" << std::endl;
+        } else {
+            std::string draft_path;
+            try {
+                draft_path = resolve_draft_model(draft_model, do_not_upgrade);
+            } catch (const std::exception& e) {
+                if (!registry_draft) {
+                    throw;
+                }
+                LOG(WARNING, "LlamaCpp") << "Loading without default draft model " << draft_model
+                                         << ": " << e.what() << std::endl;
+            }
+
+            if (!draft_path.empty()) {
+                LOG(INFO, "LlamaCpp") << "Using draft model for speculative decoding: " << draft_model << std::endl;
+                push_arg(args, reserved_flags, "--model-draft", draft_path, std::vector<std::string>{"-md"});
+                push_arg(args, reserved_flags, "-ngld", gpu_layers, std::vector<std::string>{"--gpu-layers-draft", "--n-gpu-layers-draft"});
+                // Small drafts are cheap: propose up to 16 tokens, but only bother once at least 2 are likely
+                push_overridable_arg(args, llamacpp_args, "--draft-max", "16");
+                push_overridable_arg(args, llamacpp_args, "--draft-min", "2");
+                push_overridable_arg(args, llamacpp_args, "--draft-p-min", "0.75");
+            }
+        }
+    }
+
+    // Enable slot save/restore so conversation KV state survives slot reuse and eviction
+    slot_cache_dir_.clear();
+    slots_.clear();
+    json slot_cache = options.get_option("slot_cache");
+    if (slot_cache.is_number_integer() && slot_cache.get<int>() > 0 && model_info.type == ModelType::LLM) {
+        // Replicas of a model share one directory, so a conversation's next turn can be
+        // restored by whichever replica the router sends it to
+        fs::path slot_dir = fs::path(get_cache_dir()) / "slot_cache" / sanitize_dir_name(model_name);
+        std::error_code ec;
+        fs::create_directories(slot_dir, ec);
+        if (ec) {
+            LOG(WARNING, "LlamaCpp") << "Could not create slot cache directory " << slot_dir.string()
+                                     << ": " << ec.message() << std::endl;
+        } else {
+            slot_cache_dir_ = slot_dir.string();
+            // Remove saves this replica left unfinished when it last exited
+            for (const auto& entry : fs::directory_iterator(slot_dir, ec)) {
+                if (entry.path().filename().string().find(slot_temp_suffix()) != std::string::npos) {
+                    fs::remove(entry.path(), ec);
+                }
+            }
+            LOG(DEBUG, "LlamaCpp") << "Slot cache directory: " << slot_cache_dir_ << std::endl;
+            push_arg(args, reserved_flags, "--slot-save-path", slot_cache_dir_);
+        }
+    }
+
+    // Split CPU cores between replicas so CPU-only instances don't contend for the same threads
+    if (!use_gpu && replica_count_ > 1) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        unsigned int per_replica = cores / replica_count_;
+        if (per_replica > 0) {
+            unsigned int first = replica_index_ * per_replica;
+            unsigned int last = first + per_replica - 1;
+            LOG(DEBUG, "LlamaCpp") << "Pinning replica " << replica_index_ << " to CPUs "
+                                   << first << "-" << last << std::endl;
+            push_overridable_arg(args, llamacpp_args, "--threads", std::to_string(per_replica));
+            push_overridable_arg(args, llamacpp_args, "--cpu-range",
+                                 std::to_string(first) + "-" + std::to_string(last));
+            push_overridable_arg(args, llamacpp_args, "--cpu-strict", "1");
+        }
+    }
+
     // Validate and append custom arguments
     if (!llamacpp_args.empty()) {
         std::string validation_error = validate_custom_args(llamacpp_args, reserved_flags);
@@ -312,9 +441,47 @@ void LlamaCppServer::load(const std::string& model_name,
         throw std::runtime_error("llama-server failed to start");
     }
 
+    // One entry per llama-server slot (--parallel); without /slots only slot 0 is used
+    if (!slot_cache_dir_.empty()) {
+        size_t slot_count = 1;
+        try {
+            auto response = HttpClient::get(get_base_url() + "/slots");
+            json slots = json::parse(response.body, nullptr, false);
+            if (response.status_code == 200 && slots.is_array() && !slots.empty()) {
+                slot_count = slots.size();
+            }
+        } catch (const std::exception& e) {
+            LOG(WARNING, "LlamaCpp") << "Could not list slots: " << e.what() << std::endl;
+        }
+        std::lock_guard<std::mutex> lock(slot_mutex_);
+        slots_.assign(slot_count, Slot{});
+        LOG(DEBUG, "LlamaCpp") << "Slot cache managing " << slot_count << " slot(s)" << std::endl;
+    }
+
     LOG(DEBUG, "LlamaCpp") << "Model loaded on port " << port_ << std::endl;
 }
 
+std::string LlamaCppServer::resolve_draft_model(const std::string& draft_model, bool do_not_upgrade) {
+    if (!model_manager_->model_exists(draft_model)) {
+        throw std::runtime_error("Draft model not found: " + draft_model);
+    }
+    ModelInfo draft_info = model_manager_->get_model_info(draft_model);
+    if (draft_info.recipe != "llamacpp") {
+        throw std::invalid_argument("Draft model " + draft_model + " must use the llamacpp recipe");
+    }
+    if (!model_manager_->is_model_downloaded(draft_model)) {
+        LOG(INFO, "LlamaCpp") << "Downloading draft model: " << draft_model << std::endl;
+        model_manager_->download_registered_model(draft_info, do_not_upgrade);
+        draft_info = model_manager_->get_model_info(draft_model);
+    }
+
+    std::string draft_path = draft_info.resolved_path();
+    if (draft_path.empty()) {
+        throw std::runtime_error("GGUF file not found for draft model: " + draft_model);
+    }
+    return draft_path;
+}
+
 void LlamaCppServer::unload() {
     LOG(INFO, "LlamaCpp") << "Unloading model..." << std::endl;
 #ifdef _WIN32
@@ -322,6 +489,17 @@ void LlamaCppServer::unload() {
 #else
     if (process_handle_.pid > 0) {
 #endif
+        // Persist the resident conversations so a later reload can skip the re-prefill
+        {
+            std::lock_guard<std::mutex> lock(slot_mutex_);
+            for (size_t i = 0; i < slots_.size() && !slot_cache_dir_.empty(); i++) {
+                if (!slots_[i].conversation.empty()) {
+                    save_slot(static_cast<int>(i), slots_[i].conversation);
+                }
+            }
+            slots_.clear();
+        }
+        slot_cv_.notify_all();
         ProcessManager::stop_process(process_handle_);
         process_handle_ = {nullptr, 0};
         port_ = 0;
@@ -329,24 +507,31 @@ void LlamaCppServer::unload() {
 }
 
 json LlamaCppServer::chat_completion(const json& request) {
-    // OpenAI API compatibility: Transform max_completion_tokens to max_tokens
-    // OpenAI deprecated max_tokens in favor of max_completion_tokens (Sep 2024)
-    // but llama.cpp only supports the older max_tokens parameter
+    // OpenAI API compatibility: Transform max_completion_tokens to max_tokens.
+    // Only copy the (possibly large) request when something actually has to change.
+    if (!JsonUtils::needs_max_tokens(request) && slot_cache_dir_.empty()) {
+        return forward_request("/v1/chat/completions", request);
+    }
+
     json modified_request = request;
-    if (modified_request.contains("max_completion_tokens") && !modified_request.contains("max_tokens")) {
+    if (JsonUtils::needs_max_tokens(modified_request)) {
         modified_request["max_tokens"] = modified_request["max_completion_tokens"];
     }
+    SlotLease lease(*this, acquire_slot(modified_request));
+    if (lease.slot >= 0) {
+        modified_request["id_slot"] = lease.slot;
+    }
     return forward_request("/v1/chat/completions", modified_request);
 }
 
 json LlamaCppServer::completion(const json& request) {
     // OpenAI API compatibility: Transform max_completion_tokens to max_tokens
-    // OpenAI deprecated max_tokens in favor of max_completion_tokens (Sep 2024)
-    // but llama.cpp only supports the older max_tokens parameter
-    json modified_request = request;
-    if (modified_request.contains("max_completion_tokens") && !modified_request.contains("max_tokens")) {
-        modified_request["max_tokens"] = modified_request["max_completion_tokens"];
+    if (!JsonUtils::needs_max_tokens(request)) {
+        return forward_request("/v1/completions", request);
     }
+
+    json modified_request = request;
+    modified_request["max_tokens"] = modified_request["max_completion_tokens"];
     return forward_request("/v1/completions", modified_request);
 }
 
@@ -362,5 +547,176 @@ json LlamaCppServer::responses(const json& request) {
     return forward_request("/v1/responses", request);
 }
 
+void LlamaCppServer::forward_streaming_request(const std::string& endpoint,
+                                               const std::string& request_body,
+                                               httplib::DataSink& sink,
+                                               bool sse,
+                                               long timeout_seconds) {
+    // The HTTP handlers already mapped max_completion_tokens, so the client's bytes are
+    // forwarded untouched unless the slot cache has to pick a slot
+    if (slot_cache_dir_.empty() || endpoint != "/v1/chat/completions") {
+        WrappedServer::forward_streaming_request(endpoint, request_body, sink, sse, timeout_seconds);
+        return;
+    }
+
+    // The conversation key needs the messages, so this path does parse the body
+    json request = json::parse(request_body, nullptr, false);
+    if (request.is_discarded()) {
+        WrappedServer::forward_streaming_request(endpoint, request_body, sink, sse, timeout_seconds);
+        return;
+    }
+
+    SlotLease lease(*this, acquire_slot(request));
+    if (lease.slot < 0) {
+        WrappedServer::forward_streaming_request(endpoint, request_body, sink, sse, timeout_seconds);
+        return;
+    }
+
+    // Splice id_slot into the original bytes rather than serializing the whole request again
+    std::string slotted_body = request_body;
+    if (request.contains("id_slot") || !JsonUtils::insert_field(slotted_body, "id_slot", lease.slot)) {
+        request["id_slot"] = lease.slot;
+        slotted_body = request.dump();
+    }
+    WrappedServer::forward_streaming_request(endpoint, slotted_body, sink, sse, timeout_seconds);
+}
+
+int LlamaCppServer::acquire_slot(const json& request) {
+    if (slot_cache_dir_.empty()) {
+        return -1;
+    }
+
+    std::string key = get_conversation_key(model_name_, request);
+    if (key.empty()) {
+        return -1;
+    }
+
+    int slot = -1;
+    std::string evicted;
+    bool restore = false;
+    {
+        std::unique_lock<std::mutex> lock(slot_mutex_);
+        slot_cv_.wait(lock, [&] {
+            if (slots_.empty()) {
+                return true;  // Unloaded
+            }
+            slot = -1;
+            for (size_t i = 0; i < slots_.size(); i++) {
+                if (!slots_[i].busy && slots_[i].conversation == key) {
+                    slot = static_cast<int>(i);
+                    return true;
+                }
+            }
+            // Take over the least recently used free slot. A busy slot holding the same key
+            // (a parallel request, or another client with the same opening turn) is not
+            // waited for: the request restores the last saved state into its own slot.
+            for (size_t i = 0; i < slots_.size(); i++) {
+                if (!slots_[i].busy && (slot < 0 || slots_[i].last_used < slots_[slot].last_used)) {
+                    slot = static_cast<int>(i);
+                }
+            }
+            return slot >= 0;
+        });
+        if (slots_.empty() || slot < 0) {
+            return -1;
+        }
+
+        Slot& owned = slots_[slot];
+        owned.busy = true;
+        owned.last_used = ++slot_clock_;
+        if (owned.conversation != key) {
+            evicted = owned.conversation;
+            owned.conversation = key;
+            restore = true;
+        }
+    }
+
+    // The slot is ours until release_slot, so its state can be swapped without the lock
+    if (restore) {
+        if (!evicted.empty()) {
+            save_slot(slot, evicted);
+            prune_slot_cache();
+        }
+        std::error_code ec;
+        if (fs::exists(fs::path(slot_cache_dir_) / (key + ".bin"), ec)) {
+            slot_action(slot, "restore", key + ".bin");
+        }
+    }
+    return slot;
+}
+
+void LlamaCppServer::release_slot(int slot) {
+    if (slot < 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(slot_mutex_);
+        if (static_cast<size_t>(slot) < slots_.size()) {
+            slots_[slot].busy = false;
+        }
+    }
+    slot_cv_.notify_all();
+}
+
+std::string LlamaCppServer::slot_temp_suffix() const {
+    return ".replica-" + std::to_string(replica_index_) + ".tmp";
+}
+
+void LlamaCppServer::save_slot(int slot, const std::string& conversation_key) {
+    // Replicas share the directory and may save the same conversation at once, so each
+    // writes its own temporary file and renames it over the previous save
+    std::string temp_name = conversation_key + slot_temp_suffix();
+    if (!slot_action(slot, "save", temp_name)) {
+        return;
+    }
+    std::error_code ec;
+    fs::rename(fs::path(slot_cache_dir_) / temp_name, fs::path(slot_cache_dir_) / (conversation_key + ".bin"), ec);
+    if (ec) {
+        LOG(WARNING, "LlamaCpp") << "Could not store slot file for conversation " << conversation_key
+                                 << ": " << ec.message() << std::endl;
+        fs::remove(fs::path(slot_cache_dir_) / temp_name, ec);
+    }
+}
+
+bool LlamaCppServer::slot_action(int slot, const std::string& action, const std::string& filename) {
+    std::string url = get_base_url() + "/slots/" + std::to_string(slot) + "?action=" + action;
+    json body = {{"filename", filename}};
+
+    try {
+        auto response = HttpClient::post(url, body.dump(), {{"Content-Type", "application/json"}});
+        if (response.status_code == 200) {
+            LOG(DEBUG, "LlamaCpp") << "Slot " << slot << " " << action << " " << filename
+                                   << ": " << response.body << std::endl;
+            return true;
+        }
+        LOG(WARNING, "LlamaCpp") << "Slot " << action << " failed (HTTP " << response.status_code
+                                 << "): " << response.body << std::endl;
+    } catch (const std::exception& e) {
+        LOG(WARNING, "LlamaCpp") << "Slot " << action << " failed: " << e.what() << std::endl;
+    }
+    return false;
+}
+
+void LlamaCppServer::prune_slot_cache() {
+    std::vector<std::pair<fs::file_time_type, fs::path>> files;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(slot_cache_dir_, ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ".bin") {
+            files.emplace_back(entry.last_write_time(ec), entry.path());
+        }
+    }
+
+    if (files.size() <= MAX_SAVED_SLOTS) {
+        return;
+    }
+
+    // Oldest first
+    std::sort(files.begin(), files.end());
+    for (size_t i = 0; i < files.size() - MAX_SAVED_SLOTS; i++) {
+        LOG(DEBUG, "LlamaCpp") << "Removing old slot file: " << files[i].second.string() << std::endl;
+        fs::remove(files[i].second, ec);
+    }
+}
+
 } // namespace backends
 } // namespace lemon
@@ -5,8 +5,10 @@
 #include "lemon/utils/custom_args.h"
 #include "lemon/utils/http_client.h"
 #include "lemon/utils/process_manager.h"
+#include "lemon/utils/audio_utils.h"
 #include "lemon/error_types.h"
 #include <httplib.h>
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
@@ -230,6 +232,7 @@ void WhisperServer::load(const std::string& model_name,
         std::vector<std::string> custom_args_vec = parse_custom_args(whispercpp_args);
         args.insert(args.end(), custom_args_vec.begin(), custom_args_vec.end());
     }
+    ffmpeg_convert_ = std::find(args.begin(), args.end(), "--convert") != args.end();
 
     // Note: whisper-server doesn't support --debug flag
 
@@ -525,18 +528,17 @@ json WhisperServer::forward_multipart_audio_request(const std::string& file_path
     }
 }
 
-json WhisperServer::forward_multipart_audio_data(const std::string& audio_data,
-                                                  const std::string& filename,
+json WhisperServer::forward_multipart_audio_data(const audio::AudioPayload& audio,
                                                   const json& params,
                                                   bool translate) {
-    if (audio_data.empty()) {
+    if (audio.empty()) {
         throw std::runtime_error("Empty audio data");
     }
 
-    LOG(DEBUG, "WhisperServer") << "Audio data size: " << audio_data.size() << " bytes (no file I/O)" << std::endl;
+    LOG(DEBUG, "WhisperServer") << "Audio data size: " << audio.size() << " bytes (no file I/O)" << std::endl;
 
     // Determine content type based on filename extension
-    fs::path filepath(filename);
+    fs::path filepath(audio.filename);
     std::string ext = filepath.extension().string();
     std::string content_type = "audio/wav";  // Default
 
@@ -547,15 +549,23 @@ json WhisperServer::forward_multipart_audio_data(const std::string& audio_data,
     else if (ext == ".flac") content_type = "audio/flac";
     else if (ext == ".webm") content_type = "audio/webm";
 
-    // Build multipart form data
+    // Build multipart form data. The audio part is written straight from the shared buffer
+    // instead of being copied into the form first.
     httplib::UploadFormDataItems items;
 
-    httplib::UploadFormData audio_file;
-    audio_file.name = "file";
-    audio_file.content = audio_data;
-    audio_file.filename = filepath.filename().string();
-    audio_file.content_type = content_type;
-    items.push_back(audio_file);
+    httplib::FormDataProviderItems audio_parts;
+    audio_parts.push_back({
+        "file",
+        [data = audio.data](size_t offset, httplib::DataSink& sink) {
+            if (offset < data->size() && !sink.write(data->data() + offset, data->size() - offset)) {
+                return false;
+            }
+            sink.done();
+            return true;
+        },
+        filepath.filename().string(),
+        content_type
+    });
 
     std::string response_format = params.value("response_format", "json");
     httplib::UploadFormData fmt_field;
@@ -599,7 +609,7 @@ json WhisperServer::forward_multipart_audio_data(const std::string& audio_data,
     LOG(DEBUG, "WhisperServer") << "Sending multipart request to http://127.0.0.1:"
               << port_ << "/inference (direct data)" << std::endl;
 
-    httplib::Result res = cli.Post("/inference", items);
+    httplib::Result res = cli.Post("/inference", httplib::Headers(), items, audio_parts);
 
     if (!res) {
         throw std::runtime_error("HTTP request failed: " + httplib::to_string(res.error()));
@@ -620,18 +630,22 @@ json WhisperServer::forward_multipart_audio_data(const std::string& audio_data,
 }
 
 // IAudioServer implementation
-json WhisperServer::audio_transcriptions(const json& request) {
+json WhisperServer::audio_transcriptions(const json& request, const audio::AudioPayload& audio) {
     try {
-        // Extract audio data from request
-        if (!request.contains("file_data")) {
-            throw std::runtime_error("Missing 'file_data' in request");
+        // Without --convert, whisper-server only reads 16 kHz WAV, so WAV uploads at other
+        // rates, channel counts or sample formats are converted to 16 kHz mono PCM16 here.
+        // With --convert it runs ffmpeg on every upload anyway, so they are forwarded as-is
+        // like compressed formats.
+        std::string converted;
+        if (!ffmpeg_convert_ && !audio.empty() && utils::AudioUtils::to_whisper_wav(audio.bytes(), converted)) {
+            LOG(DEBUG, "WhisperServer") << "Converted " << audio.filename << " to 16 kHz mono PCM16 ("
+                      << audio.size() << " -> " << converted.size() << " bytes)" << std::endl;
+            audio::AudioPayload resampled(std::move(converted), fs::path(audio.filename).stem().string() + ".wav");
+            return forward_multipart_audio_data(resampled, request, false);
         }
 
-        std::string audio_data = request["file_data"].get<std::string>();
-        std::string filename = request.value("filename", "audio.wav");
-
         // Send directly to whisper-server without file I/O
-        return forward_multipart_audio_data(audio_data, filename, request, false);
+        return forward_multipart_audio_data(audio, request, false);
 
     } catch (const std::exception& e) {
         return json{
@@ -77,6 +77,93 @@ static void add_serve_options(CLI::App* serve, ServerConfig& config) {
                 return "Value must be a positive integer or -1 for unlimited (got '" + val + "')";
             }
         });
+
+    // Priority scheduling
+    serve->add_option("--request-slots", config.request_slots,
+                   "Concurrent requests dispatched per model replica; extra requests queue by priority. 0 disables queueing.")
+        ->envname("LEMONADE_REQUEST_SLOTS")
+        ->type_name("N")
+        ->default_val(config.request_slots)
+        ->check(CLI::NonNegativeNumber);
+
+    serve->add_option("--batch-share", config.batch_share,
+                   "Fraction of a model's request slots that batch-priority requests may occupy")
+        ->envname("LEMONADE_BATCH_SHARE")
+        ->type_name("FRACTION")
+        ->default_val(config.batch_share)
+        ->check(CLI::Range(0.0, 1.0));
+
+    // HTTP worker pool
+    serve->add_option("--http-threads", config.http_threads,
+                   "HTTP worker threads always kept available for incoming requests")
+        ->envname("LEMONADE_HTTP_THREADS")
+        ->type_name("N")
+        ->default_val(config.http_threads)
+        ->check(CLI::Range(1, 1024));
+
+    serve->add_option("--http-max-threads", config.http_max_threads,
+                   "Upper limit the HTTP worker pool may grow to while streams occupy workers")
+        ->envname("LEMONADE_HTTP_MAX_THREADS")
+        ->type_name("N")
+        ->default_val(config.http_max_threads)
+        ->check(CLI::Range(1, 4096));
+
+    // The pool never shrinks below --http-threads, so it can't start above its growth limit
+    serve->final_callback([&config]() {
+        if (config.http_threads > config.http_max_threads) {
+            throw CLI::ValidationError("--http-threads", "must not exceed --http-max-threads (" +
+                                       std::to_string(config.http_threads) + " > " +
+                                       std::to_string(config.http_max_threads) + ")");
+        }
+    });
+
+    serve->add_option("--stream-stall-timeout", config.stream_stall_timeout,
+                   "Seconds a streaming client may stop reading before its stream is dropped (0 = never)")
+        ->envname("LEMONADE_STREAM_STALL_TIMEOUT")
+        ->type_name("SECONDS")
+        ->default_val(config.stream_stall_timeout)
+        ->check(CLI::NonNegativeNumber);
+
+    // HTTP connection tuning
+    serve->add_option("--http-keep-alive-requests", config.http_keep_alive_requests,
+                   "Requests served on one keep-alive connection before the server closes it")
+        ->envname("LEMONADE_HTTP_KEEP_ALIVE_REQUESTS")
+        ->type_name("N")
+        ->default_val(config.http_keep_alive_requests)
+        ->check(CLI::Range(1, 1000000));
+
+    serve->add_option("--http-keep-alive-timeout", config.http_keep_alive_timeout,
+                   "Seconds an idle keep-alive connection is held open waiting for the next request")
+        ->envname("LEMONADE_HTTP_KEEP_ALIVE_TIMEOUT")
+        ->type_name("SECONDS")
+        ->default_val(config.http_keep_alive_timeout)
+        ->check(CLI::Range(1, 3600));
+
+    serve->add_option("--http-tcp-nodelay", config.http_tcp_nodelay,
+                   "Disable Nagle's algorithm on client connections so streamed tokens are sent immediately")
+        ->envname("LEMONADE_HTTP_TCP_NODELAY")
+        ->type_name("BOOL")
+        ->default_val(config.http_tcp_nodelay);
+
+    serve->add_option("--http-socket-buffer", config.http_socket_buffer,
+                   "Send/receive buffer size in bytes for client connections (0 = OS default)")
+        ->envname("LEMONADE_HTTP_SOCKET_BUFFER")
+        ->type_name("BYTES")
+        ->default_val(config.http_socket_buffer)
+        ->check(CLI::NonNegativeNumber);
+
+    serve->add_option("--unix-socket", config.unix_socket,
+                   "Unix domain socket for local clients: 'auto' (runtime directory), 'off', or a path. Not available on Windows.")
+        ->envname("LEMONADE_UNIX_SOCKET")
+        ->type_name("PATH")
+        ->default_val(config.unix_socket);
+
+    serve->add_option("--tts-cache-size", config.tts_cache_size,
+                   "Disk space in MB for caching synthesized speech of repeated phrases (0 disables the cache)")
+        ->envname("LEMONADE_TTS_CACHE_SIZE")
+        ->type_name("MB")
+        ->default_val(config.tts_cache_size)
+        ->check(CLI::NonNegativeNumber);
     RecipeOptions::add_cli_options(*serve, config.recipe_options);
 }
 
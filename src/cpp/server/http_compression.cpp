@@ -0,0 +1,210 @@
+#include "lemon/http_compression.h"
+#include "lemon/utils/hash_utils.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace lemon {
+namespace http_compression {
+
+const std::vector<std::string>& available_encodings() {
+    static const std::vector<std::string> encodings = [] {
+        std::vector<std::string> list;
+#ifdef CPPHTTPLIB_ZSTD_SUPPORT
+        list.push_back("zstd");
+#endif
+#ifdef CPPHTTPLIB_BROTLI_SUPPORT
+        list.push_back("br");
+#endif
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+        list.push_back("gzip");
+#endif
+        return list;
+    }();
+    return encodings;
+}
+
+static std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(start, end - start + 1);
+}
+
+std::vector<std::string> accepted_encodings(const std::string& accept_encoding) {
+    std::vector<std::string> result;
+    if (accept_encoding.empty()) {
+        return result;
+    }
+
+    // Collect the codings the client accepts (q > 0)
+    std::vector<std::string> accepted;
+    bool wildcard = false;
+    std::stringstream ss(accept_encoding);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        std::string coding = trim(item.substr(0, item.find(';')));
+        std::transform(coding.begin(), coding.end(), coding.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+
+        double q = 1.0;
+        size_t q_pos = item.find("q=");
+        if (q_pos != std::string::npos) {
+            try {
+                q = std::stod(item.substr(q_pos + 2));
+            } catch (...) {
+                q = 1.0;
+            }
+        }
+        if (q <= 0.0) {
+            continue;
+        }
+
+        if (coding == "*") {
+            wildcard = true;
+        } else {
+            accepted.push_back(coding);
+        }
+    }
+
+    for (const auto& encoding : available_encodings()) {
+        if (wildcard || std::find(accepted.begin(), accepted.end(), encoding) != accepted.end()) {
+            result.push_back(encoding);
+        }
+    }
+    return result;
+}
+
+std::string negotiate(const std::string& accept_encoding) {
+    std::vector<std::string> encodings = accepted_encodings(accept_encoding);
+    return encodings.empty() ? "" : encodings.front();
+}
+
+bool is_compressible(const std::string& content_type) {
+    std::string type = content_type.substr(0, content_type.find(';'));
+    if (type == "text/event-stream") {
+        return false;
+    }
+    return type.rfind("text/", 0) == 0 ||
+           type == "application/json" ||
+           type == "application/javascript" ||
+           type == "image/svg+xml" ||
+           type == "image/x-icon";
+}
+
+bool compress(const std::string& encoding, const std::string& input, std::string& output) {
+    std::unique_ptr<httplib::detail::compressor> compressor;
+#ifdef CPPHTTPLIB_ZSTD_SUPPORT
+    if (encoding == "zstd") compressor.reset(new httplib::detail::zstd_compressor());
+#endif
+#ifdef CPPHTTPLIB_BROTLI_SUPPORT
+    if (encoding == "br") compressor.reset(new httplib::detail::brotli_compressor());
+#endif
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+    if (encoding == "gzip") compressor.reset(new httplib::detail::gzip_compressor());
+#endif
+    if (!compressor) {
+        return false;
+    }
+
+    output.clear();
+    return compressor->compress(input.data(), input.size(), true,
+                                [&output](const char* data, size_t length) {
+                                    output.append(data, length);
+                                    return true;
+                                });
+}
+
+void send_compressed(const httplib::Request& req, httplib::Response& res,
+                     std::string body, const std::string& content_type) {
+    if (body.size() >= MIN_COMPRESS_BYTES && is_compressible(content_type)) {
+        std::string encoding = negotiate(req.get_header_value("Accept-Encoding"));
+        auto compressed = std::make_shared<std::string>();
+        if (!encoding.empty() && compress(encoding, body, *compressed) &&
+            compressed->size() < body.size()) {
+            res.set_header("Content-Encoding", encoding);
+            res.set_header("Vary", "Accept-Encoding");
+            res.set_content_provider(
+                compressed->size(), content_type,
+                [compressed](size_t offset, size_t length, httplib::DataSink& sink) {
+                    return sink.write(compressed->data() + offset, length);
+                });
+            return;
+        }
+    }
+
+    res.set_content(std::move(body), content_type);
+}
+
+void send_representation(const httplib::Request& req, httplib::Response& res,
+                         const Representations& body, const std::string& cache_control, bool vary) {
+    std::string encoding;
+    std::shared_ptr<const std::string> bytes = body.identity;
+    for (const auto& accepted : accepted_encodings(req.get_header_value("Accept-Encoding"))) {
+        auto variant = body.encoded.find(accepted);
+        if (variant != body.encoded.end() && variant->second) {
+            encoding = accepted;
+            bytes = variant->second;
+            break;
+        }
+    }
+
+    std::string etag = "\"" + body.etag + (encoding.empty() ? "" : "-" + encoding) + "\"";
+    res.set_header("ETag", etag);
+    res.set_header("Cache-Control", cache_control);
+    if (vary) {
+        res.set_header("Vary", "Accept-Encoding");
+    }
+
+    std::string if_none_match = req.get_header_value("If-None-Match");
+    if (!if_none_match.empty() &&
+        (if_none_match == "*" || if_none_match.find(etag) != std::string::npos)) {
+        res.status = 304;
+        return;
+    }
+
+    if (!encoding.empty()) {
+        res.set_header("Content-Encoding", encoding);
+    }
+    res.set_content_provider(
+        bytes->size(), body.content_type,
+        [bytes](size_t offset, size_t length, httplib::DataSink& sink) {
+            return sink.write(bytes->data() + offset, length);
+        });
+}
+
+CachedBody::CachedBody(std::string body, std::string content_type) {
+    // Content hash: identical content keeps its ETag across restarts
+    body_.etag = utils::fnv1a_64_hex(body) + "-" + std::to_string(body.size());
+    body_.content_type = std::move(content_type);
+    body_.identity = std::make_shared<const std::string>(std::move(body));
+}
+
+void CachedBody::send(const httplib::Request& req, httplib::Response& res) {
+    if (body_.identity->size() < MIN_COMPRESS_BYTES || !is_compressible(body_.content_type)) {
+        send_representation(req, res, body_, "no-cache", false);
+        return;
+    }
+
+    // Compress on first use: try the client's encodings in order until one pays off
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& encoding : accepted_encodings(req.get_header_value("Accept-Encoding"))) {
+        auto it = body_.encoded.find(encoding);
+        if (it == body_.encoded.end()) {
+            auto out = std::make_shared<std::string>();
+            if (!compress(encoding, *body_.identity, *out) || out->size() >= body_.identity->size()) {
+                out.reset();  // Remember that this encoding does not pay off
+            }
+            it = body_.encoded.emplace(encoding, out).first;
+        }
+        if (it->second) {
+            break;
+        }
+    }
+    send_representation(req, res, body_, "no-cache", true);
+}
+
+} // namespace http_compression
+} // namespace lemon
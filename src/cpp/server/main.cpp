@@ -76,10 +76,7 @@ int main(int argc, char** argv) {
             LOG(INFO) << "  Extra models dir: " << config.extra_models_dir << std::endl;
         }
 
-        Server server(config.port, config.host, config.log_level,
-                    config.recipe_options, config.max_loaded_models,
-                    config.extra_models_dir, config.no_broadcast,
-                    config.global_timeout);
+        Server server(config);
 
         // Register signal handler for Ctrl+C
         g_server_instance = &server;
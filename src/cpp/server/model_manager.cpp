@@ -4,6 +4,7 @@
 #include <lemon/utils/process_manager.h>
 #include <lemon/utils/path_utils.h>
 #include <lemon/system_info.h>
+#include <lemon/tracing.h>
 #include <filesystem>
 #include <iostream>
 #include <fstream>
@@ -228,6 +229,12 @@ std::string ModelManager::get_hf_cache_dir() const {
 void ModelManager::invalidate_models_cache() {
     std::lock_guard<std::mutex> lock(models_cache_mutex_);
     cache_valid_ = false;
+    mark_cache_changed();
+}
+
+void ModelManager::mark_cache_changed() {
+    cache_version_++;
+    snapshot_.reset();
 }
 
 void ModelManager::set_extra_models_dir(const std::string& dir) {
@@ -236,6 +243,7 @@ void ModelManager::set_extra_models_dir(const std::string& dir) {
     // Invalidate cache so discovered models are included on next access
     std::lock_guard<std::mutex> lock(models_cache_mutex_);
     cache_valid_ = false;
+    mark_cache_changed();
 
     if (!extra_models_dir_.empty()) {
         LOG(INFO, "ModelManager") << "Extra models directory set to: " << extra_models_dir_ << std::endl;
@@ -666,6 +674,21 @@ std::map<std::string, ModelInfo> ModelManager::get_supported_models() {
     return models_cache_;
 }
 
+ModelSnapshot ModelManager::get_models_snapshot(uint64_t* version) {
+    // Build cache if needed (lazy initialization)
+    build_cache();
+
+    // One copy per cache version, shared by every caller until the cache changes
+    std::lock_guard<std::mutex> lock(models_cache_mutex_);
+    if (!snapshot_) {
+        snapshot_ = std::make_shared<const std::map<std::string, ModelInfo>>(models_cache_);
+    }
+    if (version) {
+        *version = cache_version_;
+    }
+    return snapshot_;
+}
+
 static void load_checkpoints(ModelInfo& info, json& model_json) {
     if (model_json.contains("checkpoints") && model_json["checkpoints"].is_object()) {
         for (auto& [key, value] : model_json["checkpoints"].items()) {
@@ -735,6 +758,7 @@ void ModelManager::build_cache() {
         info.recipe = JsonUtils::get_or_default<std::string>(value, "recipe", "");
         info.suggested = JsonUtils::get_or_default<bool>(value, "suggested", false);
         info.size = JsonUtils::get_or_default<double>(value, "size", 0.0);
+        info.draft_model = JsonUtils::get_or_default<std::string>(value, "draft_model", "");
 
         if (value.contains("labels") && value["labels"].is_array()) {
             for (const auto& label : value["labels"]) {
@@ -772,6 +796,7 @@ void ModelManager::build_cache() {
         info.suggested = JsonUtils::get_or_default<bool>(value, "suggested", true);
         info.source = JsonUtils::get_or_default<std::string>(value, "source", "");
         info.size = JsonUtils::get_or_default<double>(value, "size", 0.0);
+        info.draft_model = JsonUtils::get_or_default<std::string>(value, "draft_model", "");
 
         if (value.contains("labels") && value["labels"].is_array()) {
             for (const auto& label : value["labels"]) {
@@ -834,7 +859,12 @@ void ModelManager::build_cache() {
             base_options["height"] = info.image_defaults.height;
         }
 
-        // User-saved recipe options override image_defaults
+        // Registry draft model pairing (speculative decoding)
+        if (!info.draft_model.empty()) {
+            base_options["draft_model"] = info.draft_model;
+        }
+
+        // User-saved recipe options override image_defaults and draft pairing
         if (JsonUtils::has_key(recipe_options_, name)) {
             LOG(INFO, "ModelManager") << "Found recipe options for model: " << name << std::endl;
             auto saved_options = recipe_options_[name];
@@ -920,6 +950,7 @@ void ModelManager::build_cache() {
     }
 
     cache_valid_ = true;
+    mark_cache_changed();
     LOG(INFO, "ModelManager") << "Cache built: " << models_cache_.size()
               << " total, " << downloaded_count << " downloaded" << std::endl;
 }
@@ -1020,6 +1051,7 @@ void ModelManager::add_model_to_cache(const std::string& model_name) {
     }
 
     models_cache_[model_name] = info;
+    mark_cache_changed();
     LOG(INFO, "ModelManager") << "Added '" << model_name << "' to cache (downloaded=" << info.downloaded << ")" << std::endl;
 }
 
@@ -1033,6 +1065,7 @@ void ModelManager::update_model_options_in_cache(const ModelInfo& info) {
     auto it = models_cache_.find(info.model_name);
     if (it != models_cache_.end()) {
         it->second.recipe_options = info.recipe_options;
+        mark_cache_changed();
     } else {
         LOG(WARNING, "ModelManager") << "'" << info.model_name << "' not found in cache" << std::endl;
     }
@@ -1048,6 +1081,7 @@ void ModelManager::update_model_in_cache(const std::string& model_name, bool dow
     auto it = models_cache_.find(model_name);
     if (it != models_cache_.end()) {
         it->second.downloaded = downloaded;
+        mark_cache_changed();
 
         // Recompute resolved_path after download
         // The path changes now that files exist on disk
@@ -1074,6 +1108,8 @@ void ModelManager::remove_model_from_cache(const std::string& model_name) {
 
     auto it = models_cache_.find(model_name);
     if (it != models_cache_.end()) {
+        mark_cache_changed();
+
         // User models and local uploads should be removed entirely from cache
         // (they're not in server_models.json, so keeping them makes no sense)
         bool is_user_model = model_name.substr(0, 5) == "user.";
@@ -1576,6 +1612,8 @@ bool ModelManager::is_model_downloaded(const std::string& model_name) {
 }
 
 void ModelManager::download_registered_model(const ModelInfo& info, bool do_not_upgrade, DownloadProgressCallback progress_callback) {
+    tracing::Span span("download", info.model_name);
+
     // Use FLM pull for FLM models, otherwise download from HuggingFace
     if (info.recipe == "flm") {
         download_from_flm(info.checkpoint(), do_not_upgrade, progress_callback);
@@ -1,11 +1,17 @@
 #include "lemon/ollama_api.h"
 #include "lemon/model_types.h"
+#include "lemon/http_compression.h"
 #include <iostream>
 #include <lemon/utils/aixlog.hpp>
 #include <sstream>
 #include <algorithm>
 #include <thread>
 #include <vector>
+#include <chrono>
+#include <ctime>
+#include <cctype>
+#include <cmath>
+#include <limits>
 
 namespace lemon {
 
@@ -209,10 +215,85 @@ std::string OllamaApi::normalize_model_name(const std::string& name) {
 // ============================================================================
 // auto-load model if needed (mirrors Server::auto_load_model_if_needed)
 // ============================================================================
-void OllamaApi::auto_load_model(const std::string& model) {
+// Parse Ollama's keep_alive: a number of seconds or a Go-style duration ("5m", "1h30m", "-1").
+// Returns -1 for "never unload". Throws std::invalid_argument for malformed values.
+static int parse_keep_alive(const json& keep_alive) {
+    double seconds = 0;
+
+    if (keep_alive.is_number()) {
+        seconds = keep_alive.get<double>();
+    } else if (keep_alive.is_string()) {
+        std::string value = keep_alive.get<std::string>();
+        size_t pos = 0;
+        bool negative = !value.empty() && value[0] == '-';
+        if (negative) {
+            pos = 1;
+        }
+        if (pos >= value.size()) {
+            throw std::invalid_argument("invalid keep_alive: " + value);
+        }
+
+        while (pos < value.size()) {
+            size_t consumed = 0;
+            double amount = std::stod(value.substr(pos), &consumed);
+            pos += consumed;
+
+            size_t unit_end = pos;
+            while (unit_end < value.size() && std::isalpha(static_cast<unsigned char>(value[unit_end]))) {
+                unit_end++;
+            }
+            std::string unit = value.substr(pos, unit_end - pos);
+            pos = unit_end;
+
+            if (unit.empty() || unit == "s") {
+                seconds += amount;
+            } else if (unit == "ms") {
+                seconds += amount / 1000.0;
+            } else if (unit == "m") {
+                seconds += amount * 60;
+            } else if (unit == "h") {
+                seconds += amount * 3600;
+            } else {
+                throw std::invalid_argument("invalid keep_alive unit: " + unit);
+            }
+        }
+        if (negative) {
+            seconds = -seconds;
+        }
+    } else {
+        throw std::invalid_argument("keep_alive must be a number or duration string");
+    }
+
+    if (std::isnan(seconds)) {
+        throw std::invalid_argument("invalid keep_alive: not a number");
+    }
+    if (seconds < 0) {
+        return -1;
+    }
+    // Converting an out-of-range double to int is undefined; anything this long means "forever" anyway
+    if (seconds >= static_cast<double>(std::numeric_limits<int>::max())) {
+        return std::numeric_limits<int>::max();
+    }
+    return static_cast<int>(seconds);
+}
+
+void OllamaApi::auto_load_model(const std::string& model, const json& keep_alive) {
     std::string name = normalize_model_name(model);
 
+    // Apply the request's keep_alive (if any) to the loaded model
+    auto apply_keep_alive = [this, &name, &keep_alive]() {
+        if (keep_alive.is_null()) {
+            return;
+        }
+        try {
+            router_->set_keep_alive(name, parse_keep_alive(keep_alive));
+        } catch (const std::exception& e) {
+            LOG(WARNING, "OllamaApi") << "Ignoring keep_alive: " << e.what() << std::endl;
+        }
+    };
+
     if (router_->is_model_loaded(name)) {
+        apply_keep_alive();
         return;
     }
 
@@ -233,6 +314,7 @@ void OllamaApi::auto_load_model(const std::string& model) {
 
     router_->load_model(name, info, RecipeOptions(info.recipe, json::object()), true);
     LOG(INFO, "OllamaApi") << "Model loaded: " << name << std::endl;
+    apply_keep_alive();
 }
 
 // build Ollama model entry from ModelInfo
@@ -582,7 +664,7 @@ void OllamaApi::handle_chat(const httplib::Request& req, httplib::Response& res)
 
         // Auto-load the model
         try {
-            auto_load_model(model);
+            auto_load_model(model, request_json.value("keep_alive", json()));
         } catch (const std::exception& e) {
             res.status = 404;
             json error = {{"error", "model '" + model + "' not found, try pulling it first"}};
@@ -602,10 +684,11 @@ void OllamaApi::handle_chat(const httplib::Request& req, httplib::Response& res)
             // Set streaming body as OpenAI format with stream=true
             openai_req["stream"] = true;
             std::string openai_body = openai_req.dump();
+            std::string routed_model = openai_req.value("model", "");
 
             res.set_chunked_content_provider(
                 "application/x-ndjson",
-                [this, openai_body, model](size_t offset, httplib::DataSink& sink) {
+                [this, openai_body, model, routed_model](size_t offset, httplib::DataSink& sink) {
                     if (offset > 0) return false;
                     stream_sse_to_ndjson(openai_body, sink,
                         // Convert each SSE chunk to Ollama chat format
@@ -624,8 +707,8 @@ void OllamaApi::handle_chat(const httplib::Request& req, httplib::Response& res)
                             };
                         },
                         // Router stream function
-                        [this](const std::string& body, httplib::DataSink& s) {
-                            router_->chat_completion_stream(body, s);
+                        [this, &routed_model](const std::string& body, httplib::DataSink& s) {
+                            router_->chat_completion_stream(routed_model, body, s);
                         }
                     );
                     return false;
@@ -683,7 +766,7 @@ void OllamaApi::handle_generate(const httplib::Request& req, httplib::Response&
         }
 
         try {
-            auto_load_model(model);
+            auto_load_model(model, request_json.value("keep_alive", json()));
         } catch (const std::exception& e) {
             res.status = 404;
             json error = {{"error", "model '" + model + "' not found, try pulling it first"}};
@@ -710,10 +793,11 @@ void OllamaApi::handle_generate(const httplib::Request& req, httplib::Response&
 
             openai_req["stream"] = true;
             std::string openai_body = openai_req.dump();
+            std::string routed_model = openai_req.value("model", "");
 
             res.set_chunked_content_provider(
                 "application/x-ndjson",
-                [this, openai_body, model](size_t offset, httplib::DataSink& sink) {
+                [this, openai_body, model, routed_model](size_t offset, httplib::DataSink& sink) {
                     if (offset > 0) return false;
                     stream_sse_to_ndjson(openai_body, sink,
                         // Convert each SSE chunk to Ollama generate format
@@ -749,8 +833,8 @@ void OllamaApi::handle_generate(const httplib::Request& req, httplib::Response&
                             };
                         },
                         // Router stream function
-                        [this](const std::string& body, httplib::DataSink& s) {
-                            router_->completion_stream(body, s);
+                        [this, &routed_model](const std::string& body, httplib::DataSink& s) {
+                            router_->completion_stream(routed_model, body, s);
                         }
                     );
                     return false;
@@ -904,7 +988,7 @@ void OllamaApi::handle_tags(const httplib::Request& req, httplib::Response& res)
             response["models"].push_back(build_ollama_model_entry(id, info));
         }
 
-        res.set_content(response.dump(), "application/json");
+        http_compression::send_compressed(req, res, response.dump(), "application/json");
 
     } catch (const std::exception& e) {
         LOG(ERROR, "OllamaApi") << "Error in /api/tags: " << e.what() << std::endl;
@@ -1106,7 +1190,7 @@ void OllamaApi::handle_embed(const httplib::Request& req, httplib::Response& res
         }
 
         try {
-            auto_load_model(model);
+            auto_load_model(model, request_json.value("keep_alive", json()));
         } catch (const std::exception& e) {
             res.status = 404;
             json error = {{"error", "model '" + model + "' not found"}};
@@ -1171,7 +1255,7 @@ void OllamaApi::handle_embeddings(const httplib::Request& req, httplib::Response
         }
 
         try {
-            auto_load_model(model);
+            auto_load_model(model, request_json.value("keep_alive", json()));
         } catch (const std::exception& e) {
             res.status = 404;
             json error = {{"error", "model '" + model + "' not found"}};
@@ -1217,6 +1301,24 @@ void OllamaApi::handle_embeddings(const httplib::Request& req, httplib::Response
     }
 }
 
+// ISO-8601 time at which a model with the given remaining keep-alive will be unloaded
+static std::string format_expires_at(long long expires_in) {
+    if (expires_in < 0) {
+        return "2099-01-01T00:00:00Z";  // Never unloaded
+    }
+    std::time_t expires = std::chrono::system_clock::to_time_t(
+        std::chrono::system_clock::now() + std::chrono::seconds(expires_in));
+    std::tm tm_utc{};
+#ifdef _WIN32
+    gmtime_s(&tm_utc, &expires);
+#else
+    gmtime_r(&expires, &tm_utc);
+#endif
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm_utc);
+    return buf;
+}
+
 // ============================================================================
 // GET /api/ps — List running models
 // ============================================================================
@@ -1238,7 +1340,7 @@ void OllamaApi::handle_ps(const httplib::Request& req, httplib::Response& res) {
                     {"size", 0},
                     {"digest", "sha256:0000000000000000000000000000000000000000000000000000000000000000"},
                     {"details", build_ollama_details(name, recipe, checkpoint)},
-                    {"expires_at", "2099-01-01T00:00:00Z"},
+                    {"expires_at", format_expires_at(m.value("expires_in", -1))},
                     {"size_vram", 0}
                 };
                 response["models"].push_back(entry);
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 #include <lemon/utils/aixlog.hpp>
 
 #ifdef _WIN32
@@ -14,19 +15,80 @@
 
 namespace lemon {
 
+// Upload name for buffered realtime audio
+static const char* REALTIME_FILENAME = "realtime_audio.wav";
+
+// Build the VAD engine selected by turn_detection.type ("server_vad" or "spectral_vad")
+static std::unique_ptr<VoiceActivityDetector> create_vad(const json& td) {
+    std::string type = td.value("type", "server_vad");
+
+    if (type == "spectral_vad") {
+        SpectralVAD::Config vad_config;
+
+        // OpenAI clients send threshold as a 0-1 sensitivity (default 0.5). The spectral
+        // engine compares against the SNR over the noise floor, so map 0-1 onto 3-15 dB
+        // (0.5 -> the 9 dB default), or take dB directly from snr_threshold_db.
+        if (td.contains("snr_threshold_db")) {
+            vad_config.snr_threshold_db = td["snr_threshold_db"].get<float>();
+        } else if (td.contains("threshold")) {
+            float threshold = (std::max)(0.0f, (std::min)(1.0f, td["threshold"].get<float>()));
+            vad_config.snr_threshold_db = 3.0f + 12.0f * threshold;
+        }
+        if (td.contains("silence_duration_ms")) {
+            vad_config.min_silence_ms = td["silence_duration_ms"].get<int>();
+        }
+        if (td.contains("prefix_padding_ms")) {
+            vad_config.min_speech_ms = td["prefix_padding_ms"].get<int>();
+        }
+
+        return std::make_unique<SpectralVAD>(vad_config);
+    }
+
+    if (type != "server_vad") {
+        LOG(WARNING, "RealtimeSession") << "Unknown turn_detection.type '" << type
+                  << "', using server_vad" << std::endl;
+    }
+
+    SimpleVAD::Config vad_config;
+
+    if (td.contains("threshold")) {
+        vad_config.energy_threshold = td["threshold"].get<float>();
+    }
+    if (td.contains("silence_duration_ms")) {
+        vad_config.min_silence_ms = td["silence_duration_ms"].get<int>();
+    }
+    if (td.contains("prefix_padding_ms")) {
+        vad_config.min_speech_ms = td["prefix_padding_ms"].get<int>();
+    }
+
+    return std::make_unique<SimpleVAD>(vad_config);
+}
+
+// Apply input_sample_rate (Lemonade extension): PCM16 at other rates is resampled to 16 kHz
+static void apply_input_sample_rate(RealtimeSession& session, const json& config) {
+    if (!config.contains("input_sample_rate")) {
+        return;
+    }
+
+    const auto& rate = config["input_sample_rate"];
+    if (!rate.is_number_integer() || rate.get<int>() < 8000 || rate.get<int>() > 192000) {
+        LOG(WARNING, "RealtimeSession") << "Ignoring invalid input_sample_rate: " << rate.dump() << std::endl;
+        return;
+    }
+    session.audio_buffer.set_input_sample_rate(rate.get<int>());
+}
+
 RealtimeSessionManager::RealtimeSessionManager(Router* router)
-    : router_(router) {
+    : router_(router),
+      executor_(TRANSCRIPTION_WORKERS, [router](const std::string& model) {
+          // whisper-server handles one request at a time per process
+          return router->get_loaded_replicas(model);
+      }) {
 }
 
 RealtimeSessionManager::~RealtimeSessionManager() {
-    // Wait for pending transcriptions to complete
-    {
-        std::lock_guard<std::mutex> lock(transcriptions_mutex_);
-        for (auto& f : pending_transcriptions_) {
-            if (f.valid()) f.wait();
-        }
-        pending_transcriptions_.clear();
-    }
+    // Let running transcriptions finish; queued ones are dropped
+    executor_.shutdown();
 
     // Close all sessions
     std::lock_guard<std::mutex> lock(sessions_mutex_);
@@ -62,23 +124,11 @@ std::string RealtimeSessionManager::create_session(
     if (config.contains("model")) {
         session->model = config["model"].get<std::string>();
     }
+    apply_input_sample_rate(*session, config);
 
     // Configure VAD if specified
     if (config.contains("turn_detection")) {
-        const auto& td = config["turn_detection"];
-        SimpleVAD::Config vad_config;
-
-        if (td.contains("threshold")) {
-            vad_config.energy_threshold = td["threshold"].get<float>();
-        }
-        if (td.contains("silence_duration_ms")) {
-            vad_config.min_silence_ms = td["silence_duration_ms"].get<int>();
-        }
-        if (td.contains("prefix_padding_ms")) {
-            vad_config.min_speech_ms = td["prefix_padding_ms"].get<int>();
-        }
-
-        session->vad.set_config(vad_config);
+        session->vad = create_vad(config["turn_detection"]);
     }
 
     {
@@ -112,22 +162,10 @@ void RealtimeSessionManager::update_session(const std::string& session_id, const
     if (config.contains("model")) {
         session->model = config["model"].get<std::string>();
     }
+    apply_input_sample_rate(*session, config);
 
     if (config.contains("turn_detection")) {
-        const auto& td = config["turn_detection"];
-        SimpleVAD::Config vad_config;
-
-        if (td.contains("threshold")) {
-            vad_config.energy_threshold = td["threshold"].get<float>();
-        }
-        if (td.contains("silence_duration_ms")) {
-            vad_config.min_silence_ms = td["silence_duration_ms"].get<int>();
-        }
-        if (td.contains("prefix_padding_ms")) {
-            vad_config.min_speech_ms = td["prefix_padding_ms"].get<int>();
-        }
-
-        session->vad.set_config(vad_config);
+        session->vad = create_vad(config["turn_detection"]);
     }
 
     // Send session updated message (OpenAI-compatible)
@@ -151,7 +189,21 @@ void RealtimeSessionManager::append_audio(const std::string& session_id, const s
 
     // Append to buffer
     session->audio_buffer.append(base64_audio);
+    on_audio_appended(session);
+}
+
+void RealtimeSessionManager::append_audio_raw(const std::string& session_id, const uint8_t* data, size_t size) {
+    auto session = get_session(session_id);
+    if (!session || !session->session_active) {
+        return;
+    }
+
+    // Raw frames skip JSON parsing and base64 decoding entirely
+    session->audio_buffer.append_raw(data, size);
+    on_audio_appended(session);
+}
 
+void RealtimeSessionManager::on_audio_appended(std::shared_ptr<RealtimeSession> session) {
     // Log buffer growth periodically (every ~5 seconds at 256ms chunks ≈ every 20 chunks)
     static int chunk_count = 0;
     if (++chunk_count % 20 == 1) {
@@ -164,30 +216,23 @@ void RealtimeSessionManager::append_audio(const std::string& session_id, const s
 }
 
 void RealtimeSessionManager::process_vad(std::shared_ptr<RealtimeSession> session) {
-    // Get recent audio for VAD processing (last 100ms)
-    auto recent_audio = session->audio_buffer.get_recent_samples(100);
-    if (recent_audio.empty()) {
+    if (session->audio_buffer.empty()) {
         return;
     }
 
-    // Log RMS periodically for threshold tuning
-    {
-        float sum_sq = 0.0f;
-        for (float s : recent_audio) sum_sq += s * s;
-        float rms = std::sqrt(sum_sq / static_cast<float>(recent_audio.size()));
-        static int vad_log_count = 0;
-        if (++vad_log_count % 20 == 1) {
-            LOG(DEBUG, "RealtimeSession") << "VAD: RMS=" << rms
-                      << " speech_active=" << session->vad.is_speech_active() << std::endl;
-        }
-    }
+    VoiceActivityDetector::Event event = session->vad->process(session->audio_buffer);
 
-    SimpleVAD::Event event = session->vad.process(recent_audio, StreamingAudioBuffer::SAMPLE_RATE);
+    // Log RMS periodically for threshold tuning (measured by the VAD itself)
+    static int vad_log_count = 0;
+    if (++vad_log_count % 20 == 1) {
+        LOG(DEBUG, "RealtimeSession") << "VAD: RMS=" << session->vad->last_rms()
+                  << " speech_active=" << session->vad->is_speech_active() << std::endl;
+    }
 
     switch (event) {
-        case SimpleVAD::Event::SpeechStart: {
+        case VoiceActivityDetector::Event::SpeechStart: {
             LOG(DEBUG, "RealtimeSession") << "VAD: SpeechStart detected" << std::endl;
-            session->audio_start_ms = session->vad.speech_start_ms();
+            session->audio_start_ms = session->vad->speech_start_ms();
             session->last_interim_transcription_ms = 0;  // Reset interim tracking for new utterance
 
             if (session->send_message) {
@@ -200,9 +245,9 @@ void RealtimeSessionManager::process_vad(std::shared_ptr<RealtimeSession> sessio
             break;
         }
 
-        case SimpleVAD::Event::SpeechEnd: {
+        case VoiceActivityDetector::Event::SpeechEnd: {
             LOG(DEBUG, "RealtimeSession") << "VAD: SpeechEnd detected, triggering transcription" << std::endl;
-            int64_t audio_end_ms = session->vad.speech_end_ms();
+            int64_t audio_end_ms = session->vad->speech_end_ms();
 
             if (session->send_message) {
                 json msg = {
@@ -217,10 +262,10 @@ void RealtimeSessionManager::process_vad(std::shared_ptr<RealtimeSession> sessio
             break;
         }
 
-        case SimpleVAD::Event::None:
+        case VoiceActivityDetector::Event::None:
         default:
             // Speech is ongoing — check if we should fire an interim transcription
-            if (session->vad.is_speech_active()) {
+            if (session->vad->is_speech_active()) {
                 maybe_interim_transcribe(session);
             }
             break;
@@ -253,30 +298,38 @@ void RealtimeSessionManager::transcribe_interim(std::shared_ptr<RealtimeSession>
         return;  // Another interim is already running
     }
 
-    // Snapshot the buffer WITHOUT clearing it
-    auto wav_data = session->audio_buffer.get_wav_padded(500);
+    // Snapshot only the current window of the buffer, WITHOUT clearing it
+    size_t window_start = 0;
+    uint64_t utterance = 0;
+    std::string prompt;
+    {
+        std::lock_guard<std::mutex> lock(session->interim_mutex);
+        window_start = session->window_start_sample;
+        utterance = session->utterance;
+        prompt = session->stitcher.prompt();
+    }
+    size_t window_end = session->audio_buffer.sample_count();
+    audio::AudioPayload wav(session->audio_buffer.get_wav_from(window_start, 500), REALTIME_FILENAME);
     std::string model = session->model;
     session->last_interim_transcription_ms = session->audio_buffer.duration_ms();
 
     LOG(DEBUG, "RealtimeSession") << "Firing interim transcription at "
-              << session->last_interim_transcription_ms << "ms" << std::endl;
-
-    auto future = std::async(std::launch::async,
-        [this, session, wav_data = std::move(wav_data), model = std::move(model)]() {
-            transcribe_wav(session, wav_data, model, /*is_interim=*/true);
+              << session->last_interim_transcription_ms << "ms (window "
+              << (window_end - window_start) * 1000 / StreamingAudioBuffer::SAMPLE_RATE
+              << "ms)" << std::endl;
+
+    // interim_in_flight stays set until the job runs or is dropped as stale
+    bool queued = executor_.submit(session->session_id, model, TranscriptionExecutor::Kind::Interim,
+        [this, session, wav = std::move(wav), model,
+         prompt = std::move(prompt), window_start, window_end, utterance]() {
+            transcribe_window(session, wav, model, prompt, window_start, window_end, utterance);
+            session->interim_in_flight.store(false);
+        },
+        [session]() {
             session->interim_in_flight.store(false);
         });
-
-    {
-        std::lock_guard<std::mutex> lock(transcriptions_mutex_);
-        pending_transcriptions_.erase(
-            std::remove_if(pending_transcriptions_.begin(), pending_transcriptions_.end(),
-                [](const std::future<void>& f) {
-                    return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
-                }),
-            pending_transcriptions_.end()
-        );
-        pending_transcriptions_.push_back(std::move(future));
+    if (!queued) {
+        session->interim_in_flight.store(false);
     }
 }
 
@@ -305,7 +358,9 @@ void RealtimeSessionManager::clear_audio(const std::string& session_id) {
     }
 
     session->audio_buffer.clear();
-    session->vad.reset();
+    session->vad->reset();
+    reset_interim(*session);
+    executor_.drop_interim(session_id);
 
     if (session->send_message) {
         json msg = {
@@ -320,107 +375,194 @@ void RealtimeSessionManager::transcribe_and_send(std::shared_ptr<RealtimeSession
         return;
     }
 
+    // Audio before the interim window start is already transcribed (frozen text), so
+    // the final pass only needs the window, prompted with the frozen text alone
+    size_t window_start = 0;
+    std::string frozen_text;
+    std::string prompt;
+    {
+        std::lock_guard<std::mutex> lock(session->interim_mutex);
+        window_start = session->window_start_sample;
+        frozen_text = session->stitcher.frozen_text();
+        prompt = session->stitcher.prompt();
+    }
+
     // Snapshot WAV data and clear buffer on the callback thread (no data race)
-    auto wav_data = session->audio_buffer.get_wav_padded(500);
+    audio::AudioPayload wav(session->audio_buffer.get_wav_from(window_start, 500), REALTIME_FILENAME);
     std::string model = session->model;
     session->audio_buffer.clear();
-    session->vad.reset();
+    session->vad->reset();
     session->last_interim_transcription_ms = 0;  // Reset for next utterance
-
-    // Dispatch transcription to worker thread so it doesn't block the WebSocket callback
-    auto future = std::async(std::launch::async,
-        [this, session, wav_data = std::move(wav_data), model = std::move(model)]() {
-            transcribe_wav(session, wav_data, model);
+    reset_interim(*session);
+
+    // Queue the transcription so it doesn't block the WebSocket callback; this also drops
+    // the session's queued interim passes for the utterance that just ended
+    executor_.submit(session->session_id, model, TranscriptionExecutor::Kind::Final,
+        [this, session, wav = std::move(wav), model,
+         prompt = std::move(prompt), frozen_text = std::move(frozen_text)]() {
+            transcribe_wav(session, wav, model, prompt, frozen_text);
         });
+}
 
-    // Track future for clean shutdown
-    {
-        std::lock_guard<std::mutex> lock(transcriptions_mutex_);
-        // Remove completed futures
-        pending_transcriptions_.erase(
-            std::remove_if(pending_transcriptions_.begin(), pending_transcriptions_.end(),
-                [](const std::future<void>& f) {
-                    return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
-                }),
-            pending_transcriptions_.end()
-        );
-        pending_transcriptions_.push_back(std::move(future));
+void RealtimeSessionManager::reset_interim(RealtimeSession& session) {
+    std::lock_guard<std::mutex> lock(session.interim_mutex);
+    session.stitcher.reset();
+    session.window_start_sample = 0;
+    session.utterance++;
+}
+
+json RealtimeSessionManager::request_transcription(const audio::AudioPayload& wav,
+                                                   const std::string& model,
+                                                   const std::string& prompt,
+                                                   bool timestamps) {
+    // Build transcription request (the WAV snapshot is passed alongside, not copied into it)
+    json request = {
+        {"model", model}
+    };
+    if (!prompt.empty()) {
+        request["prompt"] = prompt;  // Text heard before this audio, for continuity
+    }
+    if (timestamps) {
+        request["response_format"] = "verbose_json";  // Segment end times for window trimming
     }
+
+    return router_->audio_transcriptions(request, wav);
 }
 
-void RealtimeSessionManager::transcribe_wav(
+void RealtimeSessionManager::send_transcription_error(std::shared_ptr<RealtimeSession> session,
+                                                      const std::exception& e) {
+    LOG(ERROR, "RealtimeSession") << "Transcription error: " << e.what() << std::endl;
+
+    if (session->send_message && session->session_active.load()) {
+        json error_msg = {
+            {"type", "error"},
+            {"error", {
+                {"message", std::string("Transcription failed: ") + e.what()},
+                {"type", "transcription_error"}
+            }}
+        };
+        session->send_message(error_msg);
+    }
+}
+
+void RealtimeSessionManager::transcribe_window(
     std::shared_ptr<RealtimeSession> session,
-    std::vector<uint8_t> wav_data, std::string model,
-    bool is_interim) {
+    audio::AudioPayload wav, std::string model, std::string prompt,
+    size_t window_start, size_t window_end, uint64_t utterance) {
     try {
-        // Convert WAV bytes to a string for the router (expects file_data as string)
-        std::string file_data(reinterpret_cast<const char*>(wav_data.data()), wav_data.size());
-
-        // Build transcription request
-        json request = {
-            {"model", model},
-            {"file_data", file_data},
-            {"filename", "realtime_audio.wav"}
-        };
+        LOG(DEBUG, "RealtimeSession") << "Calling Whisper interim transcription ("
+                  << wav.size() << " bytes)..." << std::endl;
+        json response = request_transcription(wav, model, prompt, /*timestamps=*/true);
+        LOG(DEBUG, "RealtimeSession") << "Whisper interim response: " << response.dump() << std::endl;
+
+        std::string transcript;
+        {
+            std::lock_guard<std::mutex> lock(session->interim_mutex);
+            if (utterance != session->utterance || window_start != session->window_start_sample) {
+                return;  // The utterance ended while Whisper was running
+            }
 
-        // Call router for transcription
-        const char* tag = is_interim ? "interim" : "final";
-        LOG(DEBUG, "RealtimeSession") << "Calling Whisper " << tag << " transcription ("
-                  << wav_data.size() << " bytes)..." << std::endl;
-        json response = router_->audio_transcriptions(request);
-        LOG(DEBUG, "RealtimeSession") << "Whisper " << tag << " response: " << response.dump() << std::endl;
+            session->stitcher.update(TranscriptStitcher::words_from_response(response));
+
+            // Keep the next window bounded: move its start past the committed text
+            int window_ms = static_cast<int>((window_end - window_start) * 1000 / StreamingAudioBuffer::SAMPLE_RATE);
+            if (window_ms > INTERIM_WINDOW_MS) {
+                double committed_end_s = session->stitcher.committed_end_s();
+                if (committed_end_s > 0.0) {
+                    size_t offset = static_cast<size_t>(committed_end_s * StreamingAudioBuffer::SAMPLE_RATE);
+                    session->window_start_sample = (std::min)(window_start + offset, window_end);
+                    session->stitcher.advance_window();
+                } else if (window_ms > INTERIM_MAX_WINDOW_MS) {
+                    session->window_start_sample = window_end;
+                    session->stitcher.flush_window();
+                }
+            }
+
+            transcript = session->stitcher.text();
+        }
 
         // Send transcription result if session is still active
         if (session->send_message && session->session_active.load()) {
-            std::string transcript;
-            if (response.contains("text")) {
-                transcript = response["text"].get<std::string>();
-            }
-
-            LOG(DEBUG, "RealtimeSession") << "Sending " << tag << " transcript to client: \""
+            LOG(DEBUG, "RealtimeSession") << "Sending interim transcript to client: \""
                       << transcript << "\"" << std::endl;
 
-            if (is_interim) {
-                // Interim/partial result — client should treat as replaceable
-                json msg = {
-                    {"type", "conversation.item.input_audio_transcription.delta"},
-                    {"delta", transcript}
-                };
-                session->send_message(msg);
-            } else {
-                // Final result — speech segment is complete
-                json msg = {
-                    {"type", "conversation.item.input_audio_transcription.completed"},
-                    {"transcript", transcript}
-                };
-                session->send_message(msg);
-            }
+            // Interim/partial result — client should treat as replaceable
+            json msg = {
+                {"type", "conversation.item.input_audio_transcription.delta"},
+                {"delta", transcript}
+            };
+            session->send_message(msg);
         }
 
     } catch (const std::exception& e) {
-        LOG(ERROR, "RealtimeSession") << "Transcription error: " << e.what() << std::endl;
+        send_transcription_error(session, e);
+    }
+}
+
+void RealtimeSessionManager::transcribe_wav(
+    std::shared_ptr<RealtimeSession> session,
+    audio::AudioPayload wav, std::string model,
+    std::string prompt, std::string frozen_text) {
+    try {
+        // Call router for transcription
+        LOG(DEBUG, "RealtimeSession") << "Calling Whisper final transcription ("
+                  << wav.size() << " bytes)..." << std::endl;
+        json response = request_transcription(wav, model, prompt, /*timestamps=*/false);
+        LOG(DEBUG, "RealtimeSession") << "Whisper final response: " << response.dump() << std::endl;
 
+        // Send transcription result if session is still active
         if (session->send_message && session->session_active.load()) {
-            json error_msg = {
-                {"type", "error"},
-                {"error", {
-                    {"message", std::string("Transcription failed: ") + e.what()},
-                    {"type", "transcription_error"}
-                }}
+            std::string transcript = frozen_text;
+            if (response.contains("text") && response["text"].is_string()) {
+                std::string window_text = response["text"].get<std::string>();
+                if (!transcript.empty() && !window_text.empty() && window_text[0] != ' ') {
+                    transcript += ' ';
+                }
+                transcript += window_text;
+            }
+
+            LOG(DEBUG, "RealtimeSession") << "Sending final transcript to client: \""
+                      << transcript << "\"" << std::endl;
+
+            // Final result — speech segment is complete
+            json msg = {
+                {"type", "conversation.item.input_audio_transcription.completed"},
+                {"transcript", transcript}
             };
-            session->send_message(error_msg);
+            session->send_message(msg);
         }
+
+    } catch (const std::exception& e) {
+        send_transcription_error(session, e);
     }
 }
 
 void RealtimeSessionManager::close_session(const std::string& session_id) {
-    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
 
-    auto it = sessions_.find(session_id);
-    if (it != sessions_.end()) {
-        it->second->session_active = false;
-        sessions_.erase(it);
+        auto it = sessions_.find(session_id);
+        if (it != sessions_.end()) {
+            it->second->session_active = false;
+            sessions_.erase(it);
+        }
     }
+
+    // Nobody is left to read interim results
+    executor_.drop_interim(session_id);
+}
+
+json RealtimeSessionManager::get_stats() const {
+    size_t sessions = 0;
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        sessions = sessions_.size();
+    }
+
+    return {
+        {"sessions", sessions},
+        {"transcriptions", executor_.get_stats()}
+    };
 }
 
 bool RealtimeSessionManager::session_exists(const std::string& session_id) const {
@@ -11,6 +11,10 @@ static const json DEFAULTS = {
     {"ctx_size", 4096},
     {"llamacpp_backend", ""},  // Will be overridden dynamically
     {"llamacpp_args", ""},
+    {"replicas", 1},       // Number of backend processes serving the model
+    {"slot_cache", 0},     // 1 = persist conversation KV cache to disk between turns
+    {"idle_timeout", 0},   // Seconds of inactivity before the model is unloaded (0 = never)
+    {"draft_model", ""},   // Registry name of a small same-tokenizer model for speculative decoding
     {"sd-cpp_backend", ""},  // sd.cpp backend selection (cpu or rocm)
     {"whispercpp_backend", ""},
     {"whispercpp_args", ""},
@@ -44,6 +48,30 @@ static const json CLI_OPTIONS = {
         {"envname", "LEMONADE_LLAMACPP_ARGS"},
         {"help", "Custom arguments to pass to llama-server (must not conflict with managed args)"}
     }},
+    {"--draft-model", {
+        {"option_name", "draft_model"},
+        {"type_name", "MODEL"},
+        {"envname", "LEMONADE_DRAFT_MODEL"},
+        {"help", "Model to use as the speculative decoding draft for llama-server (must share the main model's tokenizer)"}
+    }},
+    {"--replicas", {
+        {"option_name", "replicas"},
+        {"type_name", "N"},
+        {"envname", "LEMONADE_REPLICAS"},
+        {"help", "Number of backend processes to start per model, load balanced by in-flight requests"}
+    }},
+    {"--slot-cache", {
+        {"option_name", "slot_cache"},
+        {"type_name", "0|1"},
+        {"envname", "LEMONADE_SLOT_CACHE"},
+        {"help", "Save and restore llama-server KV cache slots per conversation to skip re-prefilling long chats"}
+    }},
+    {"--idle-timeout", {
+        {"option_name", "idle_timeout"},
+        {"type_name", "SECONDS"},
+        {"envname", "LEMONADE_IDLE_TIMEOUT"},
+        {"help", "Unload a model after it has been idle for this many seconds (0 = keep loaded)"}
+    }},
     // sd.cpp backend selection option
     {"--sdcpp", {
         {"option_name", "sd-cpp_backend"},
@@ -100,15 +128,17 @@ static const json CLI_OPTIONS = {
 
 static std::vector<std::string> get_keys_for_recipe(const std::string& recipe) {
     if (recipe == "llamacpp") {
-        return {"ctx_size", "llamacpp_backend", "llamacpp_args"};
+        return {"ctx_size", "llamacpp_backend", "llamacpp_args", "replicas", "slot_cache", "idle_timeout", "draft_model"};
     } else if (recipe == "whispercpp") {
-        return {"whispercpp_backend", "whispercpp_args"};
+        return {"whispercpp_backend", "whispercpp_args", "idle_timeout"};
     } else if (recipe == "flm") {
-        return {"ctx_size", "flm_args"};
+        return {"ctx_size", "flm_args", "idle_timeout"};
     } else if (recipe == "ryzenai-llm") {
-        return {"ctx_size"};
+        return {"ctx_size", "idle_timeout"};
     } else if (recipe == "sd-cpp") {
-        return {"sd-cpp_backend", "steps", "cfg_scale", "width", "height"};
+        return {"sd-cpp_backend", "steps", "cfg_scale", "width", "height", "idle_timeout"};
+    } else if (recipe == "kokoro") {
+        return {"idle_timeout"};
     } else {
         return {};
     }
@@ -0,0 +1,142 @@
+#include <lemon/request_scheduler.h>
+#include <lemon/utils/aixlog.hpp>
+#include <algorithm>
+#include <cctype>
+
+namespace lemon {
+
+static thread_local RequestPriority current_request_priority = RequestPriority::NORMAL;
+
+RequestPriority request_priority_from_string(const std::string& value) {
+    std::string lower = value;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+
+    if (lower == "interactive" || lower == "high") {
+        return RequestPriority::INTERACTIVE;
+    }
+    if (lower == "batch" || lower == "low") {
+        return RequestPriority::BATCH;
+    }
+    return RequestPriority::NORMAL;
+}
+
+std::string request_priority_to_string(RequestPriority priority) {
+    switch (priority) {
+        case RequestPriority::INTERACTIVE: return "interactive";
+        case RequestPriority::BATCH: return "batch";
+        default: return "normal";
+    }
+}
+
+void RequestScheduler::configure(int slots_per_replica, double batch_share) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_per_replica_ = slots_per_replica;
+    batch_share_ = std::min(1.0, std::max(0.0, batch_share));
+
+    if (slots_per_replica_ > 0) {
+        LOG(INFO, "Scheduler") << "Priority scheduling enabled: " << slots_per_replica_
+                               << " slot(s) per replica, batch share " << batch_share_ << std::endl;
+    }
+}
+
+void RequestScheduler::set_current_priority(RequestPriority priority) {
+    current_request_priority = priority;
+}
+
+RequestPriority RequestScheduler::current_priority() {
+    return current_request_priority;
+}
+
+bool RequestScheduler::can_admit(const ModelQueue& queue, int capacity, RequestPriority priority) const {
+    if (queue.active >= capacity) {
+        return false;
+    }
+
+    switch (priority) {
+        case RequestPriority::INTERACTIVE:
+            return true;
+        case RequestPriority::NORMAL:
+            return queue.waiting[static_cast<int>(RequestPriority::INTERACTIVE)] == 0;
+        case RequestPriority::BATCH: {
+            // With two or more slots batch never takes all of them, so interactive traffic finds
+            // one free soon. A single slot is still shared (batch would otherwise starve):
+            // batch then runs only while nothing else waits, and a new interactive request
+            // waits for the running batch request to finish.
+            int batch_limit = std::max(1, static_cast<int>(capacity * batch_share_));
+            return queue.waiting[static_cast<int>(RequestPriority::INTERACTIVE)] == 0 &&
+                   queue.waiting[static_cast<int>(RequestPriority::NORMAL)] == 0 &&
+                   queue.active_batch < batch_limit;
+        }
+    }
+    return false;
+}
+
+void RequestScheduler::acquire(const std::string& model_name, int replicas, RequestPriority priority) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    int capacity = slots_per_replica_ * std::max(1, replicas);
+    ModelQueue& queue = queues_[model_name];
+    int index = static_cast<int>(priority);
+
+    if (!can_admit(queue, capacity, priority)) {
+        LOG(DEBUG, "Scheduler") << "Queueing " << request_priority_to_string(priority)
+                                << " request for " << model_name << " (" << queue.active
+                                << "/" << capacity << " slots busy)" << std::endl;
+    }
+
+    queue.waiting[index]++;
+    cv_.wait(lock, [&] { return can_admit(queue, capacity, priority); });
+    queue.waiting[index]--;
+
+    queue.active++;
+    if (priority == RequestPriority::BATCH) {
+        queue.active_batch++;
+    }
+
+    // Admission may unblock lower classes that were only waiting behind this one
+    cv_.notify_all();
+}
+
+void RequestScheduler::release(const std::string& model_name, RequestPriority priority) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = queues_.find(model_name);
+        if (it == queues_.end()) {
+            return;
+        }
+
+        ModelQueue& queue = it->second;
+        queue.active = std::max(0, queue.active - 1);
+        if (priority == RequestPriority::BATCH) {
+            queue.active_batch = std::max(0, queue.active_batch - 1);
+        }
+
+        if (queue.active == 0 && queue.waiting[0] == 0 && queue.waiting[1] == 0 && queue.waiting[2] == 0) {
+            queues_.erase(it);
+        }
+    }
+    cv_.notify_all();
+}
+
+bool RequestScheduler::has_pending(const std::string& model_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Queues are erased once they have neither active nor waiting requests
+    return queues_.count(model_name) > 0;
+}
+
+RequestScheduler::Admission::Admission(RequestScheduler& scheduler, const std::string& model_name,
+                                       int replicas, RequestPriority priority)
+    : scheduler_(scheduler), model_name_(model_name), priority_(priority), admitted_(false) {
+    if (scheduler_.is_enabled()) {
+        scheduler_.acquire(model_name_, replicas, priority_);
+        admitted_ = true;
+    }
+}
+
+RequestScheduler::Admission::~Admission() {
+    if (admitted_) {
+        scheduler_.release(model_name_, priority_);
+    }
+}
+
+} // namespace lemon
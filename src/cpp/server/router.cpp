@@ -8,12 +8,42 @@
 #include "lemon/server_capabilities.h"
 #include "lemon/error_types.h"
 #include "lemon/recipe_options.h"
+#include "lemon/tracing.h"
+#include "lemon/audio_chunking.h"
+#include "lemon/speech_segmenter.h"
+#include "lemon/audio_types.h"
+#include "lemon/utils/audio_utils.h"
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <set>
 #include <lemon/utils/aixlog.hpp>
 
 namespace lemon {
 
+// Number of backend processes to start for a model (recipe option "replicas", minimum 1)
+static int get_replica_count(const RecipeOptions& options) {
+    json replicas = options.get_option("replicas");
+    if (!replicas.is_number_integer()) {
+        return 1;
+    }
+    return std::max(1, replicas.get<int>());
+}
+
+// Seconds a model may sit idle before being unloaded (recipe option "idle_timeout", 0 = never)
+static int get_keep_alive_seconds(const RecipeOptions& options) {
+    json idle_timeout = options.get_option("idle_timeout");
+    if (!idle_timeout.is_number_integer() || idle_timeout.get<int>() <= 0) {
+        return -1;
+    }
+    return idle_timeout.get<int>();
+}
+
+// How often the idle reaper checks loaded models
+static const std::chrono::seconds IDLE_REAPER_INTERVAL(1);
+
 Router::Router(const json& default_options, const std::string& log_level, ModelManager* model_manager,
                int max_loaded_models, BackendManager* backend_manager)
     : default_options_(default_options), log_level_(log_level), model_manager_(model_manager),
@@ -24,13 +54,106 @@ Router::Router(const json& default_options, const std::string& log_level, ModelM
     } else {
     LOG(DEBUG, "Router") << "Max loaded models per type: " << max_loaded_models_ << std::endl;
     }
+
+    idle_reaper_thread_ = std::thread(&Router::idle_reaper_loop, this);
 }
 
 Router::~Router() {
+    {
+        std::lock_guard<std::mutex> lock(load_mutex_);
+        stop_idle_reaper_ = true;
+    }
+    idle_reaper_cv_.notify_all();
+    if (idle_reaper_thread_.joinable()) {
+        idle_reaper_thread_.join();
+    }
+
     LOG(DEBUG, "Router") << "Destructor: unloading all models" << std::endl;
     unload_model("");  // Unload all
 }
 
+void Router::idle_reaper_loop() {
+    std::unique_lock<std::mutex> lock(load_mutex_);
+    while (!stop_idle_reaper_) {
+        idle_reaper_cv_.wait_for(lock, IDLE_REAPER_INTERVAL, [this] { return stop_idle_reaper_; });
+        if (stop_idle_reaper_) {
+            break;
+        }
+        // Don't race a load that may be about to evict or add servers
+        if (is_loading_) {
+            continue;
+        }
+        unload_idle_models(lock);
+    }
+}
+
+void Router::unload_idle_models(std::unique_lock<std::mutex>& lock) {
+    // A model is idle only when every replica has been idle past its keep-alive
+    std::map<std::string, bool> expired;
+    std::map<std::string, long long> idle_seconds;
+    for (const auto& server : loaded_servers_) {
+        const std::string& name = server->get_model_name();
+        int keep_alive = server->get_keep_alive();
+        long long idle = std::chrono::duration_cast<std::chrono::seconds>(server->get_idle_duration()).count();
+        // Strictly greater: keep_alive 0 still leaves the request that set it time to be dispatched
+        bool server_expired = keep_alive >= 0 && !server->is_busy() && idle > keep_alive;
+
+        auto it = expired.find(name);
+        expired[name] = (it == expired.end()) ? server_expired : (it->second && server_expired);
+        idle_seconds[name] = idle;
+    }
+
+    // Requests waiting for admission are about to use the model
+    for (auto& [name, is_expired] : expired) {
+        if (is_expired && scheduler_.has_pending(name)) {
+            is_expired = false;
+        }
+    }
+
+    // Take the expired replicas out of the pool while still holding the lock, so no new
+    // request can be routed to them, then stop them without blocking other requests
+    std::vector<std::unique_ptr<WrappedServer>> idle_servers;
+    for (auto it = loaded_servers_.begin(); it != loaded_servers_.end();) {
+        if (expired[(*it)->get_model_name()]) {
+            idle_servers.push_back(std::move(*it));
+            it = loaded_servers_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (idle_servers.empty()) {
+        return;
+    }
+
+    // Loads wait until the processes are gone, as they do for a load-triggered eviction
+    is_loading_ = true;
+    lock.unlock();
+    for (auto& server : idle_servers) {
+        const std::string& name = server->get_model_name();
+        LOG(INFO, "Router") << "Unloading idle model " << name << " (idle for "
+                            << idle_seconds[name] << "s)" << std::endl;
+        try {
+            server->unload();
+        } catch (const std::exception& e) {
+            LOG(ERROR, "Router") << "Failed to unload idle model " << name << ": " << e.what() << std::endl;
+        }
+    }
+    idle_servers.clear();
+    lock.lock();
+    is_loading_ = false;
+    load_cv_.notify_all();
+}
+
+void Router::set_keep_alive(const std::string& model_name, int seconds) {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    for (const auto& server : loaded_servers_) {
+        if (server->get_model_name() == model_name) {
+            server->set_keep_alive(seconds);
+            server->update_access_time();
+        }
+    }
+}
+
 WrappedServer* Router::find_server_by_model_name(const std::string& model_name) const {
     for (const auto& server : loaded_servers_) {
         if (server->get_model_name() == model_name) {
@@ -40,6 +163,35 @@ WrappedServer* Router::find_server_by_model_name(const std::string& model_name)
     return nullptr;
 }
 
+// Helper: Pick the replica of a model with the fewest in-flight requests
+WrappedServer* Router::find_least_busy_server(const std::string& model_name) const {
+    WrappedServer* least_busy = nullptr;
+    int least_active = 0;
+
+    for (const auto& server : loaded_servers_) {
+        if (server->get_model_name() != model_name) {
+            continue;
+        }
+        int active = server->get_active_requests();
+        if (!least_busy || active < least_active) {
+            least_busy = server.get();
+            least_active = active;
+        }
+    }
+
+    return least_busy;
+}
+
+int Router::count_replicas(const std::string& model_name) const {
+    int count = 0;
+    for (const auto& server : loaded_servers_) {
+        if (server->get_model_name() == model_name) {
+            count++;
+        }
+    }
+    return count;
+}
+
 WrappedServer* Router::get_most_recent_server() const {
     if (loaded_servers_.empty()) {
         return nullptr;
@@ -55,13 +207,14 @@ WrappedServer* Router::get_most_recent_server() const {
 }
 
 int Router::count_servers_by_type(ModelType type) const {
-    int count = 0;
+    // Replicas of the same model share one slot
+    std::set<std::string> model_names;
     for (const auto& server : loaded_servers_) {
         if (server->get_model_type() == type) {
-            count++;
+            model_names.insert(server->get_model_name());
         }
     }
-    return count;
+    return static_cast<int>(model_names.size());
 }
 
 WrappedServer* Router::find_lru_server_by_type(ModelType type) const {
@@ -157,6 +310,19 @@ void Router::evict_server(WrappedServer* server) {
     LOG(INFO, "Router") << "Evicted model: " << model_name << std::endl;
 }
 
+// Helper: Evict every replica serving a model
+void Router::evict_model(const std::string& model_name) {
+    std::vector<WrappedServer*> replicas;
+    for (const auto& server : loaded_servers_) {
+        if (server->get_model_name() == model_name) {
+            replicas.push_back(server.get());
+        }
+    }
+    for (auto* server : replicas) {
+        evict_server(server);
+    }
+}
+
 void Router::evict_all_servers() {
     LOG(INFO, "Router") << "Evicting all models (" << loaded_servers_.size() << " total)" << std::endl;
 
@@ -208,10 +374,46 @@ std::unique_ptr<WrappedServer> Router::create_backend_server(const ModelInfo& mo
     return new_server;
 }
 
+std::vector<std::unique_ptr<WrappedServer>> Router::load_replicas(const std::string& model_name,
+                                                                  const ModelInfo& model_info,
+                                                                  const RecipeOptions& options,
+                                                                  bool do_not_upgrade) {
+    int replica_count = get_replica_count(options);
+    std::vector<std::unique_ptr<WrappedServer>> replicas;
+
+    // Replicas start one after another so each picks its own free port
+    try {
+        for (int i = 0; i < replica_count; i++) {
+            std::unique_ptr<WrappedServer> server = create_backend_server(model_info);
+            server->set_model_metadata(model_name, model_info.checkpoint(), model_info.type,
+                                       model_info.device, options);
+            server->set_replica(i, replica_count);
+            server->set_keep_alive(get_keep_alive_seconds(options));
+            server->update_access_time();
+
+            if (replica_count > 1) {
+                LOG(INFO, "Router") << "Starting replica " << (i + 1) << "/" << replica_count
+                                    << " of " << model_name << std::endl;
+            }
+            server->load(model_name, model_info, options, do_not_upgrade);
+            replicas.push_back(std::move(server));
+        }
+    } catch (...) {
+        // Don't leave a partially started replica set behind
+        for (auto& server : replicas) {
+            server->unload();
+        }
+        throw;
+    }
+
+    return replicas;
+}
+
 void Router::load_model(const std::string& model_name,
                        const ModelInfo& model_info,
                        RecipeOptions options,
                        bool do_not_upgrade) {
+    tracing::Span span("load_model", model_name);
     RecipeOptions default_opt = RecipeOptions(model_info.recipe, default_options_);
 
     // Resolve settings: load overrides take precedence over per-model overrides which take precedence over defaults
@@ -304,27 +506,21 @@ void Router::load_model(const std::string& model_name,
             LOG(INFO, "Router") << "Slot limit reached for type "
                           << model_type_to_string(model_type)
                           << ", evicting LRU: " << lru->get_model_name() << std::endl;
-                evict_server(lru);
+                evict_model(lru->get_model_name());
             }
         }
 
-        // Create new backend server
-        std::unique_ptr<WrappedServer> new_server = create_backend_server(model_info);
-
-        // Set model metadata
-        new_server->set_model_metadata(model_name, model_info.checkpoint(), model_type, device_type, effective_options);
-        new_server->update_access_time();
-
         // CRITICAL: Release lock before slow backend startup
         lock.unlock();
 
-        // Load the backend (this can take 30-60 seconds)
+        // Load the backend (this can take 30-60 seconds per replica)
     LOG(DEBUG, "Router") << "Starting backend (this may take a moment)..." << std::endl;
         bool load_success = false;
         std::string error_message;
+        std::vector<std::unique_ptr<WrappedServer>> new_servers;
 
         try {
-            new_server->load(model_name, model_info, effective_options, do_not_upgrade);
+            new_servers = load_replicas(model_name, model_info, effective_options, do_not_upgrade);
             load_success = true;
         LOG(DEBUG, "Router") << "Backend started successfully" << std::endl;
         } catch (const std::exception& e) {
@@ -337,7 +533,9 @@ void Router::load_model(const std::string& model_name,
 
         if (load_success) {
             // Success: Add to loaded servers
-            loaded_servers_.push_back(std::move(new_server));
+            for (auto& server : new_servers) {
+                loaded_servers_.push_back(std::move(server));
+            }
 
             is_loading_ = false;
             load_cv_.notify_all();
@@ -368,20 +566,18 @@ void Router::load_model(const std::string& model_name,
             // Mark loading again for retry
             is_loading_ = true;
 
-            // Create new server for retry
-            std::unique_ptr<WrappedServer> retry_server = create_backend_server(model_info);
-            retry_server->set_model_metadata(model_name, model_info.checkpoint(), model_type, device_type, effective_options);
-            retry_server->update_access_time();
-
             lock.unlock();
 
         LOG(DEBUG, "Router") << "Retrying backend load..." << std::endl;
             try {
-                retry_server->load(model_name, model_info, effective_options, do_not_upgrade);
+                std::vector<std::unique_ptr<WrappedServer>> retry_servers =
+                    load_replicas(model_name, model_info, effective_options, do_not_upgrade);
 
                 lock.lock();
 
-                loaded_servers_.push_back(std::move(retry_server));
+                for (auto& server : retry_servers) {
+                    loaded_servers_.push_back(std::move(server));
+                }
                 is_loading_ = false;
                 load_cv_.notify_all();
 
@@ -419,11 +615,10 @@ void Router::unload_model(const std::string& model_name) {
     } else {
         // Unload specific model
     LOG(INFO, "Router") << "Unload model called: " << model_name << std::endl;
-        WrappedServer* server = find_server_by_model_name(model_name);
-        if (!server) {
+        if (!find_server_by_model_name(model_name)) {
             throw std::runtime_error("Model not loaded: " + model_name);
         }
-        evict_server(server);
+        evict_model(model_name);
     }
 }
 
@@ -446,8 +641,24 @@ json Router::get_all_loaded_models() const {
     std::lock_guard<std::mutex> lock(load_mutex_);
 
     json result = json::array();
+    std::map<std::string, size_t> model_index;  // model_name -> position in result
 
     for (const auto& server : loaded_servers_) {
+        // Convert timestamp to milliseconds since epoch
+        auto time_point = server->get_last_access_time();
+        auto duration = time_point.time_since_epoch();
+        auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+
+        // Replicas of a model are reported as a single entry
+        auto existing = model_index.find(server->get_model_name());
+        if (existing != model_index.end()) {
+            json& model_info = result[existing->second];
+            model_info["replicas"] = model_info["replicas"].get<int>() + 1;
+            model_info["last_use"] = std::max(model_info["last_use"].get<long long>(),
+                                              static_cast<long long>(millis));
+            continue;
+        }
+
         json model_info;
         model_info["model_name"] = server->get_model_name();
         model_info["checkpoint"] = server->get_checkpoint();
@@ -457,13 +668,19 @@ json Router::get_all_loaded_models() const {
         RecipeOptions recipe_options =  server->get_recipe_options();
         model_info["recipe"] = recipe_options.get_recipe();
         model_info["recipe_options"] = recipe_options.to_json();
-
-        // Convert timestamp to milliseconds since epoch
-        auto time_point = server->get_last_access_time();
-        auto duration = time_point.time_since_epoch();
-        auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+        model_info["replicas"] = 1;
         model_info["last_use"] = millis;
 
+        // Seconds until the idle reaper unloads the model (-1 = never)
+        int keep_alive = server->get_keep_alive();
+        if (keep_alive < 0) {
+            model_info["expires_in"] = -1;
+        } else {
+            long long idle = std::chrono::duration_cast<std::chrono::seconds>(server->get_idle_duration()).count();
+            model_info["expires_in"] = std::max(0LL, keep_alive - idle);
+        }
+
+        model_index[server->get_model_name()] = result.size();
         result.push_back(model_info);
     }
 
@@ -491,6 +708,11 @@ bool Router::is_model_loaded(const std::string& model_name) const {
     return find_server_by_model_name(model_name) != nullptr;
 }
 
+int Router::get_loaded_replicas(const std::string& model_name) const {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    return count_replicas(model_name);
+}
+
 ModelType Router::get_model_type(const std::string& model_name) const {
     std::lock_guard<std::mutex> lock(load_mutex_);
     WrappedServer* server = model_name.empty()
@@ -510,20 +732,35 @@ template<typename Func>
 auto Router::execute_inference(const json& request, Func&& inference_func) -> decltype(inference_func(nullptr)) {
     WrappedServer* server = nullptr;
 
+    // Extract model from request - required field, no fallback to avoid silent misrouting
+    std::string requested_model;
+    if (request.contains("model") && request["model"].is_string()) {
+        requested_model = request["model"].get<std::string>();
+    }
+
+    if (requested_model.empty()) {
+        return ErrorResponse::from_exception(InvalidRequestException("No model specified in request"));
+    }
+
+    int replicas = 0;
     {
         std::lock_guard<std::mutex> lock(load_mutex_);
+        replicas = count_replicas(requested_model);
+    }
+    if (replicas == 0) {
+        return ErrorResponse::from_exception(ModelNotLoadedException(requested_model));
+    }
 
-        // Extract model from request - required field, no fallback to avoid silent misrouting
-        std::string requested_model;
-        if (request.contains("model") && request["model"].is_string()) {
-            requested_model = request["model"].get<std::string>();
-        }
+    // Wait for a slot according to the request's priority class (no-op when scheduling is disabled)
+    tracing::Span queue_span("queue", requested_model);
+    RequestScheduler::Admission admission(scheduler_, requested_model, replicas,
+                                          RequestScheduler::current_priority());
+    queue_span.finish();
 
-        if (requested_model.empty()) {
-            return ErrorResponse::from_exception(InvalidRequestException("No model specified in request"));
-        }
+    {
+        std::lock_guard<std::mutex> lock(load_mutex_);
 
-        server = find_server_by_model_name(requested_model);
+        server = find_least_busy_server(requested_model);
         if (!server) {
             return ErrorResponse::from_exception(ModelNotLoadedException(requested_model));
         }
@@ -534,6 +771,7 @@ auto Router::execute_inference(const json& request, Func&& inference_func) -> de
     } // Lock released here
 
     // Execute inference without holding lock (but busy flag prevents eviction)
+    tracing::Span span("inference", requested_model);
     try {
         auto response = inference_func(server);
         server->set_busy(false);
@@ -546,36 +784,41 @@ auto Router::execute_inference(const json& request, Func&& inference_func) -> de
 
 // Template method for streaming execution
 template<typename Func>
-void Router::execute_streaming(const std::string& request_body, httplib::DataSink& sink, Func&& streaming_func) {
+void Router::execute_streaming(const std::string& requested_model, httplib::DataSink& sink, Func&& streaming_func) {
     WrappedServer* server = nullptr;
 
+    // Find requested model - no fallback to avoid silent misrouting
+    if (requested_model.empty()) {
+    LOG(ERROR, "Router") << "No model specified in streaming request" << std::endl;
+        std::string error_msg = "data: {\"error\":{\"message\":\"No model specified in request\",\"type\":\"invalid_request_error\"}}\n\n";
+        sink.write(error_msg.c_str(), error_msg.size());
+        return;
+    }
+
+    std::string not_loaded_msg = "data: {\"error\":{\"message\":\"Model not loaded: " + requested_model + "\",\"type\":\"model_not_loaded\"}}\n\n";
+
+    int replicas = 0;
     {
         std::lock_guard<std::mutex> lock(load_mutex_);
+        replicas = count_replicas(requested_model);
+    }
+    if (replicas == 0) {
+        sink.write(not_loaded_msg.c_str(), not_loaded_msg.size());
+        return;
+    }
 
-        // Extract model from request body if present (same logic as execute_inference)
-        std::string requested_model;
-        try {
-            json request = json::parse(request_body);
-            if (request.contains("model") && request["model"].is_string()) {
-                requested_model = request["model"].get<std::string>();
-            }
-        } catch (...) {
-            // If JSON parsing fails, fall back to most recent server
-        LOG(DEBUG, "Router") << "Failed to parse request body for model extraction" << std::endl;
-        }
+    // Wait for a slot according to the request's priority class (no-op when scheduling is disabled)
+    tracing::Span queue_span("queue", requested_model);
+    RequestScheduler::Admission admission(scheduler_, requested_model, replicas,
+                                          RequestScheduler::current_priority());
+    queue_span.finish();
 
-        // Find requested model - no fallback to avoid silent misrouting
-        if (requested_model.empty()) {
-        LOG(ERROR, "Router") << "No model specified in streaming request" << std::endl;
-            std::string error_msg = "data: {\"error\":{\"message\":\"No model specified in request\",\"type\":\"invalid_request_error\"}}\n\n";
-            sink.write(error_msg.c_str(), error_msg.size());
-            return;
-        }
+    {
+        std::lock_guard<std::mutex> lock(load_mutex_);
 
-        server = find_server_by_model_name(requested_model);
+        server = find_least_busy_server(requested_model);
         if (!server) {
-            std::string error_msg = "data: {\"error\":{\"message\":\"Model not loaded: " + requested_model + "\",\"type\":\"model_not_loaded\"}}\n\n";
-            sink.write(error_msg.c_str(), error_msg.size());
+            sink.write(not_loaded_msg.c_str(), not_loaded_msg.size());
             return;
         }
 
@@ -583,6 +826,7 @@ void Router::execute_streaming(const std::string& request_body, httplib::DataSin
         server->update_access_time();
     }
 
+    tracing::Span span("stream", requested_model);
     try {
         streaming_func(server);
         server->set_busy(false);
@@ -634,7 +878,18 @@ json Router::responses(const json& request) {
     });
 }
 
-json Router::audio_transcriptions(const json& request) {
+json Router::audio_transcriptions(const json& request, const audio::AudioPayload& audio) {
+    if (audio.empty()) {
+        return ErrorResponse::from_exception(InvalidRequestException("No audio in transcription request"));
+    }
+
+    if (audio::chunking_requested(request)) {
+        json response = transcribe_in_chunks(request, audio);
+        if (!response.is_null()) {
+            return response;
+        }
+    }
+
     return execute_inference(request, [&](WrappedServer* server) {
         auto audio_server = dynamic_cast<IAudioServer*>(server);
         if (!audio_server) {
@@ -642,18 +897,282 @@ json Router::audio_transcriptions(const json& request) {
                 UnsupportedOperationException("Audio transcription", device_type_to_string(server->get_device_type()))
             );
         }
-        return audio_server->audio_transcriptions(request);
+        return audio_server->audio_transcriptions(request, audio);
     });
 }
 
-void Router::audio_speech(const json& request, httplib::DataSink& sink) {
-    execute_streaming(request.dump(), sink, [&](WrappedServer* server) {
+json Router::transcribe_in_chunks(const json& request, const audio::AudioPayload& audio) {
+    std::string model = request.value("model", "");
+
+    // Chunks run in parallel across replicas; a single whisper-server would only serialize them
+    int replicas = get_loaded_replicas(model);
+    if (replicas < 2) {
+        return nullptr;
+    }
+
+    // Splitting needs decoded audio: WAV (converted to 16 kHz mono) only
+    std::string converted;
+    bool was_converted = utils::AudioUtils::to_whisper_wav(audio.bytes(), converted);
+    std::vector<audio::AudioChunk> chunks = audio::split_at_silences(was_converted ? converted : audio.bytes());
+    if (chunks.size() < 2) {
+        return nullptr;
+    }
+
+    std::string response_format = request.value("response_format", std::string(audio::ResponseFormat::JSON));
+    bool timestamps = response_format == audio::ResponseFormat::VERBOSE_JSON ||
+                      response_format == audio::ResponseFormat::SRT ||
+                      response_format == audio::ResponseFormat::VTT;
+
+    LOG(INFO, "Router") << "Transcribing " << chunks.back().offset_s + chunks.back().duration_s
+                        << "s of audio as " << chunks.size() << " chunks across " << replicas
+                        << " replicas" << std::endl;
+
+    // The parameters are shared by the chunk requests
+    json base = request;
+    base.erase("chunking_strategy");
+    base["response_format"] = timestamps ? audio::ResponseFormat::VERBOSE_JSON : audio::ResponseFormat::JSON;
+
+    // One worker per replica pulls chunks in order; execute_inference sends each to the
+    // least busy replica. Workers inherit the caller's priority class and trace.
+    std::vector<json> responses(chunks.size());
+    std::vector<std::exception_ptr> errors(chunks.size());
+    std::atomic<size_t> next{0};
+    auto priority = RequestScheduler::current_priority();
+    auto request_id = tracing::current_request();
+    auto worker = [&]() {
+        RequestScheduler::set_current_priority(priority);
+        tracing::set_current_request(request_id);
+        for (size_t i = next++; i < chunks.size(); i = next++) {
+            audio::AudioPayload chunk_audio(std::move(chunks[i].wav), "chunk_" + std::to_string(i) + ".wav");
+            try {
+                responses[i] = execute_inference(base, [&](WrappedServer* server) {
+                    auto audio_server = dynamic_cast<IAudioServer*>(server);
+                    if (!audio_server) {
+                        return ErrorResponse::from_exception(
+                            UnsupportedOperationException("Audio transcription", device_type_to_string(server->get_device_type()))
+                        );
+                    }
+                    return audio_server->audio_transcriptions(base, chunk_audio);
+                });
+            } catch (...) {
+                errors[i] = std::current_exception();  // Rethrown on the calling thread
+            }
+        }
+    };
+
+    size_t worker_count = std::min(chunks.size(), static_cast<size_t>(replicas));
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < worker_count; i++) {
+        helpers.emplace_back(worker);
+    }
+    worker();
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    for (const auto& response : responses) {
+        if (response.contains("error")) {
+            return response;
+        }
+    }
+    return audio::stitch_transcriptions(responses, chunks, response_format);
+}
+
+bool Router::audio_speech(const json& request, httplib::DataSink& sink) {
+    std::string cache_key = speech_cache_.enabled() ? SpeechCache::request_key(request) : "";
+    if (!cache_key.empty() && speech_cache_.replay(cache_key, sink)) {
+        LOG(DEBUG, "Router") << "Speech served from cache" << std::endl;
+        sink.done();
+        return true;
+    }
+
+    // On a cache miss, keep a copy of the audio as it streams to the client
+    std::string audio;
+    httplib::DataSink recording_sink;
+    recording_sink.write = [&](const char* data, size_t length) {
+        if (!sink.write(data, length)) {
+            return false;
+        }
+        audio.append(data, length);
+        return true;
+    };
+    recording_sink.is_writable = [&]() { return sink.is_writable(); };
+    recording_sink.done = [&]() { sink.done(); };
+    httplib::DataSink& target = cache_key.empty() ? sink : recording_sink;
+
+    std::string requested_model = request.contains("model") && request["model"].is_string()
+                                  ? request["model"].get<std::string>() : "";
+    bool complete = false;
+    execute_streaming(requested_model, target, [&](WrappedServer* server) {
         auto tts_server = dynamic_cast<ITextToSpeechServer*>(server);
         if (!tts_server) {
             throw UnsupportedOperationException("Text to speech", device_type_to_string(server->get_device_type()));
         }
-        tts_server->audio_speech(request, sink);
+        complete = tts_server->audio_speech(request, target);
     });
+
+    // Only audio the backend finished producing is worth replaying
+    if (!cache_key.empty() && complete) {
+        speech_cache_.store(cache_key, audio);
+    }
+    return complete;
+}
+
+// Text of one chat completion SSE line ("data: {...choices[0].delta.content...}").
+// An error event is copied to error instead.
+static bool parse_chat_delta(const std::string& line, std::string& text, json& error) {
+    if (line.compare(0, 5, "data:") != 0) {
+        return false;
+    }
+    auto event = json::parse(line.begin() + 5, line.end(), nullptr, false);
+    if (event.is_discarded() || !event.is_object()) {
+        return false;  // "[DONE]"
+    }
+    if (event.contains("error")) {
+        error = event["error"];
+        return false;
+    }
+    if (!event.contains("choices") || !event["choices"].is_array() || event["choices"].empty()) {
+        return false;
+    }
+    const auto& delta = event["choices"][0].value("delta", json::object());
+    if (!delta.contains("content") || !delta["content"].is_string()) {
+        return false;
+    }
+    text = delta["content"].get<std::string>();
+    return true;
+}
+
+void Router::audio_speech_from_chat(const json& speech_request, const json& chat_request, httplib::DataSink& sink) {
+    json chat = chat_request;
+    chat["stream"] = true;
+    const std::string chat_body = chat.dump();
+    const std::string chat_model = chat.value("model", "");
+
+    std::mutex mutex;
+    std::condition_variable ready_cv;
+    std::deque<std::string> sentences;
+    bool generation_done = false;
+    json chat_error;  // Set by the generator when the chat stream fails
+    std::atomic<bool> cancelled{false};
+
+    // The LLM streams on its own thread so generation continues while sentences are spoken.
+    // It inherits the caller's priority class and trace.
+    auto priority = RequestScheduler::current_priority();
+    auto request_id = tracing::current_request();
+    std::thread generator([&]() {
+        RequestScheduler::set_current_priority(priority);
+        tracing::set_current_request(request_id);
+
+        audio::SentenceSegmenter segmenter;
+        std::string lines;
+        auto publish = [&](bool finished) {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::string sentence;
+            while (segmenter.next(sentence)) {
+                sentences.push_back(std::move(sentence));
+            }
+            while (finished && segmenter.flush(sentence)) {
+                sentences.push_back(std::move(sentence));
+            }
+            generation_done = finished;
+            ready_cv.notify_one();
+        };
+
+        httplib::DataSink chat_sink;
+        chat_sink.write = [&](const char* data, size_t length) {
+            lines.append(data, length);
+            size_t start = 0;
+            size_t newline;
+            while ((newline = lines.find('\n', start)) != std::string::npos) {
+                std::string text;
+                json error;
+                if (parse_chat_delta(lines.substr(start, newline - start), text, error)) {
+                    segmenter.push(text);
+                } else if (!error.is_null()) {
+                    LOG(ERROR, "Router") << "Chat stream for speech failed: " << error.dump() << std::endl;
+                    std::lock_guard<std::mutex> lock(mutex);
+                    chat_error = error;
+                }
+                start = newline + 1;
+            }
+            lines.erase(0, start);
+            publish(false);
+            return !cancelled;
+        };
+        chat_sink.is_writable = [&]() { return !cancelled; };
+        chat_sink.done = []() {};
+
+        try {
+            chat_completion_stream(chat_model, chat_body, chat_sink);
+        } catch (const std::exception& e) {
+            LOG(ERROR, "Router") << "Chat stream for speech failed: " << e.what() << std::endl;
+            std::lock_guard<std::mutex> lock(mutex);
+            chat_error = {{"message", e.what()}, {"type", "internal_error"}};
+        }
+        publish(true);
+    });
+
+    // Sentences share one PCM response, so the per-sentence streams must not end it
+    tracing::Span first_audio_span("first_audio", speech_request.value("model", ""));
+    bool audio_started = false;
+    httplib::DataSink audio_sink;
+    audio_sink.write = [&](const char* data, size_t length) {
+        if (!audio_started) {
+            audio_started = true;
+            first_audio_span.finish();
+        }
+        if (!sink.write(data, length)) {
+            cancelled = true;
+            return false;
+        }
+        return true;
+    };
+    audio_sink.is_writable = [&]() { return !cancelled && sink.is_writable(); };
+    audio_sink.done = []() {};
+
+    int spoken = 0;
+    while (!cancelled) {
+        std::string sentence;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready_cv.wait(lock, [&]() { return !sentences.empty() || generation_done; });
+            if (sentences.empty()) {
+                break;
+            }
+            sentence = std::move(sentences.front());
+            sentences.pop_front();
+        }
+
+        json tts_request = speech_request;
+        tts_request["input"] = sentence;
+        tts_request["stream_format"] = "audio";
+        LOG(DEBUG, "Router") << "Speaking sentence " << ++spoken << ": " << sentence << std::endl;
+        try {
+            audio_speech(tts_request, audio_sink);
+        } catch (const std::exception& e) {
+            LOG(ERROR, "Router") << "Speech synthesis failed: " << e.what() << std::endl;
+            cancelled = true;
+        }
+    }
+
+    // Stops generation early when the client disconnected or synthesis failed
+    bool client_gone = cancelled;
+    cancelled = true;
+    generator.join();
+
+    // Report a failed chat stream the same way a failed speech stream is reported. Once
+    // audio has gone out the error could not be told apart from it, so it is only logged.
+    if (!chat_error.is_null() && !audio_started && !client_gone) {
+        std::string error_msg = "data: " + json{{"error", chat_error}}.dump() + "\n\n";
+        sink.write(error_msg.c_str(), error_msg.size());
+    }
+    sink.done();
 }
 
 json Router::image_generations(const json& request) {
@@ -719,20 +1238,40 @@ void Router::update_prompt_tokens(int prompt_tokens) {
     }
 }
 
-void Router::chat_completion_stream(const std::string& request_body, httplib::DataSink& sink) {
-    execute_streaming(request_body, sink, [&](WrappedServer* server) {
+void Router::update_draft_telemetry(int draft_tokens, int draft_tokens_accepted) {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    WrappedServer* server = get_most_recent_server();
+    if (server) {
+        server->set_draft_telemetry(draft_tokens, draft_tokens_accepted);
+    }
+}
+
+void Router::configure_scheduling(int slots_per_replica, double batch_share) {
+    scheduler_.configure(slots_per_replica, batch_share);
+}
+
+void Router::configure_speech_cache(const std::string& dir, uint64_t budget_bytes) {
+    speech_cache_.configure(dir, budget_bytes);
+}
+
+json Router::get_speech_cache_stats() const {
+    return speech_cache_.get_stats();
+}
+
+void Router::chat_completion_stream(const std::string& model, const std::string& request_body, httplib::DataSink& sink) {
+    execute_streaming(model, sink, [&](WrappedServer* server) {
         server->forward_streaming_request("/v1/chat/completions", request_body, sink);
     });
 }
 
-void Router::completion_stream(const std::string& request_body, httplib::DataSink& sink) {
-    execute_streaming(request_body, sink, [&](WrappedServer* server) {
+void Router::completion_stream(const std::string& model, const std::string& request_body, httplib::DataSink& sink) {
+    execute_streaming(model, sink, [&](WrappedServer* server) {
         server->forward_streaming_request("/v1/completions", request_body, sink);
     });
 }
 
-void Router::responses_stream(const std::string& request_body, httplib::DataSink& sink) {
-    execute_streaming(request_body, sink, [&](WrappedServer* server) {
+void Router::responses_stream(const std::string& model, const std::string& request_body, httplib::DataSink& sink) {
+    execute_streaming(model, sink, [&](WrappedServer* server) {
         server->forward_streaming_request("/v1/responses", request_body, sink);
     });
 }
@@ -4,7 +4,10 @@
 #include "lemon/utils/json_utils.h"
 #include "lemon/utils/path_utils.h"
 #include "lemon/streaming_proxy.h"
+#include "lemon/static_asset_cache.h"
+#include "lemon/http_compression.h"
 #include "lemon/system_info.h"
+#include "lemon/tracing.h"
 #include "lemon/version.h"
 #ifdef LEMON_HAS_WEBSOCKET
 #include "lemon/websocket_server.h"
@@ -31,6 +34,7 @@
     #include <sys/socket.h>
     #include <netdb.h>  // Crucial for getaddrinfo and addrinfo struct
     #include <unistd.h>
+    #include <sys/stat.h>
 #endif
 
 #ifdef __APPLE__
@@ -64,15 +68,15 @@ static const json MIME_TYPES = {
     {"pcm",  "audio/l16;rate=24000;endianness=little-endian"}
 };
 
-Server::Server(int port, const std::string& host, const std::string& log_level,
-               const json& default_options, int max_loaded_models,
-               const std::string& extra_models_dir, bool no_broadcast,
-               long global_timeout)
-    : port_(port), host_(host), log_level_(log_level), default_options_(default_options),
-      no_broadcast_(no_broadcast), running_(false), udp_beacon_() {
+Server::Server(const ServerConfig& config)
+    : port_(config.port), host_(config.host), log_level_(config.log_level), default_options_(config.recipe_options),
+      no_broadcast_(config.no_broadcast), running_(false), udp_beacon_() {
 
     // Set global HttpClient timeout
-    utils::HttpClient::set_default_timeout(global_timeout);
+    utils::HttpClient::set_default_timeout(config.global_timeout);
+
+    // Drop streaming clients that stop reading instead of holding their backend slot
+    StreamingProxy::set_stall_timeout(config.stream_stall_timeout);
 
     // Detect log file path (same location as tray uses)
     // NOTE: The ServerManager is responsible for redirecting stdout/stderr to this file
@@ -95,34 +99,79 @@ Server::Server(int port, const std::string& host, const std::string& log_level,
     http_server_v6_ = std::make_unique<httplib::Server>();
 
     // CRITICAL: Enable multi-threading so the server can handle concurrent requests
-    // Without this, the server is single-threaded and blocks on long operations
-
-    std::function<httplib::TaskQueue *(void)> task_queue_factory = [this] {
-        LOG(DEBUG, "Server") << "Creating new thread pool with 8 threads" << std::endl;
-        return new httplib::ThreadPool(8);
+    // Without this, the server is single-threaded and blocks on long operations.
+    // Each listener gets an elastic pool: http_threads workers are always kept for
+    // short requests and the pool grows up to http_max_threads while streams hold workers.
+    LOG(DEBUG, "Server") << "Creating HTTP worker pools with " << config.http_threads
+                         << " threads (max " << config.http_max_threads << ")" << std::endl;
+    http_pool_ = std::make_shared<WorkerPool>(config.http_threads, config.http_max_threads);
+    http_pool_v6_ = std::make_shared<WorkerPool>(config.http_threads, config.http_max_threads);
+
+    http_server_->new_task_queue = [this] {
+        return new WorkerPool::Queue(http_pool_);
+    };
+    http_server_v6_->new_task_queue = [this] {
+        return new WorkerPool::Queue(http_pool_v6_);
     };
 
-    http_server_->new_task_queue = task_queue_factory;
-    http_server_v6_->new_task_queue = task_queue_factory;
+    // Local clients (CLI, tray) prefer the Unix socket: no TCP handshake or port conflicts
+    unix_socket_path_ = utils::get_unix_socket_path(port_, config.unix_socket);
+    if (!unix_socket_path_.empty()) {
+        http_server_unix_ = std::make_unique<httplib::Server>();
+        http_server_unix_->set_address_family(AF_UNIX);
+        http_pool_unix_ = std::make_shared<WorkerPool>(config.http_threads, config.http_max_threads);
+        http_server_unix_->new_task_queue = [this] {
+            return new WorkerPool::Queue(http_pool_unix_);
+        };
+    }
+
+    // Connection reuse: reverse proxies keep connections open and send many requests on
+    // each, so allow more requests per connection than httplib's default of 100.
+    // Buffer sizes set on the listening socket are inherited by accepted connections.
+    for (auto* web_server : {http_server_.get(), http_server_v6_.get(), http_server_unix_.get()}) {
+        if (!web_server) {
+            continue;
+        }
+        web_server->set_keep_alive_max_count(static_cast<size_t>(config.http_keep_alive_requests));
+        web_server->set_keep_alive_timeout(config.http_keep_alive_timeout);
+        web_server->set_tcp_nodelay(config.http_tcp_nodelay);
+        web_server->set_socket_options([socket_buffer = config.http_socket_buffer](socket_t sock) {
+            httplib::default_socket_options(sock);
+            if (socket_buffer > 0) {
+                int size = socket_buffer;
+                setsockopt(sock, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&size), sizeof(size));
+                setsockopt(sock, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&size), sizeof(size));
+            }
+        });
+    }
 
     model_manager_ = std::make_unique<ModelManager>();
 
     // Set extra models directory for GGUF discovery
-    model_manager_->set_extra_models_dir(extra_models_dir);
+    model_manager_->set_extra_models_dir(config.extra_models_dir);
 
     backend_manager_ = std::make_unique<BackendManager>();
 
     router_ = std::make_unique<Router>(default_options_, log_level_,
-                                       model_manager_.get(), max_loaded_models,
+                                       model_manager_.get(), config.max_loaded_models,
                                        backend_manager_.get());
+    router_->configure_scheduling(config.request_slots, config.batch_share);
+    router_->configure_speech_cache((fs::path(utils::get_cache_dir()) / "tts_cache").string(),
+                                    static_cast<uint64_t>(config.tts_cache_size) * 1024 * 1024);
 
     LOG(DEBUG, "Server") << "Debug logging enabled - subprocess output will be visible" << std::endl;
 
     const char* api_key_env = std::getenv("LEMONADE_API_KEY");
     api_key_ = api_key_env ? std::string(api_key_env) : "";
 
+    const char* batch_api_key_env = std::getenv("LEMONADE_BATCH_API_KEY");
+    batch_api_key_ = batch_api_key_env ? std::string(batch_api_key_env) : "";
+
     setup_routes(*http_server_);
     setup_routes(*http_server_v6_);
+    if (http_server_unix_) {
+        setup_routes(*http_server_unix_);
+    }
 
 #ifdef LEMON_HAS_WEBSOCKET
     // Initialize WebSocket server (binds to OS-assigned port, exposed via /health)
@@ -134,16 +183,31 @@ Server::~Server() {
     stop();
 }
 
-void Server::log_request(const httplib::Request& req) {
-    if (req.path != "/api/v0/health" && req.path != "/api/v1/health" &&
-        req.path != "/v0/health" && req.path != "/v1/health" &&
-        req.path != "/api/v0/system-stats" && req.path != "/api/v1/system-stats" &&
-        req.path != "/v0/system-stats" && req.path != "/v1/system-stats" &&
-        req.path != "/api/v0/stats" && req.path != "/api/v1/stats" &&
-        req.path != "/v0/stats" && req.path != "/v1/stats" &&
-        req.path != "/live") {
-        LOG(DEBUG, "Server") << req.method << " " << req.path << std::endl;
+// Health, stats and liveness endpoints are polled constantly; keep them out of logs and traces
+static bool is_polling_endpoint(const std::string& path) {
+    return path == "/api/v0/health" || path == "/api/v1/health" ||
+           path == "/v0/health" || path == "/v1/health" ||
+           path == "/api/v0/system-stats" || path == "/api/v1/system-stats" ||
+           path == "/v0/system-stats" || path == "/v1/system-stats" ||
+           path == "/api/v0/stats" || path == "/api/v1/stats" ||
+           path == "/v0/stats" || path == "/v1/stats" ||
+           path == "/live";
+}
+
+void Server::log_request(const httplib::Request& req, httplib::Response& res) {
+    WorkerPool::note_request();
+
+    if (is_polling_endpoint(req.path)) {
+        return;
+    }
+
+    LOG(DEBUG, "Server") << req.method << " " << req.path << std::endl;
+
+    // Reading the trace buffer should not add entries to it
+    if (req.path.size() >= 12 && req.path.compare(req.path.size() - 12, 12, "/debug/trace") == 0) {
+        return;
     }
+    res.set_header("X-Request-Id", std::to_string(tracing::begin_request()));
 }
 
 httplib::Server::HandlerResponse Server::authenticate_request(const httplib::Request& req, httplib::Response& res) {
@@ -152,14 +216,27 @@ httplib::Server::HandlerResponse Server::authenticate_request(const httplib::Req
                         (req.path.rfind("/v0/", 0) == 0) ||
                         (req.path.rfind("/v1/", 0) == 0);
 
+    std::string token = httplib::get_bearer_token_auth(req);
+    bool is_batch_key = (batch_api_key_ != "") && (token == batch_api_key_);
+
     if ((api_key_ != "") && (req.method != "OPTIONS") && is_api_route) {
-        if (api_key_ != httplib::get_bearer_token_auth(req)) {
+        if (api_key_ != token && !is_batch_key) {
             res.status = 401;
             res.set_content("{\"error\": \"Invalid or missing API key\"}", "application/json");
             return httplib::Server::HandlerResponse::Handled;
         }
     }
 
+    // Priority class for the router's scheduler: the batch API key always means batch,
+    // otherwise the client may pick one with the X-Lemonade-Priority header
+    RequestPriority priority = RequestPriority::NORMAL;
+    if (is_batch_key) {
+        priority = RequestPriority::BATCH;
+    } else if (req.has_header("X-Lemonade-Priority")) {
+        priority = request_priority_from_string(req.get_header_value("X-Lemonade-Priority"));
+    }
+    RequestScheduler::set_current_priority(priority);
+
     return httplib::Server::HandlerResponse::Unhandled;
 }
 
@@ -167,7 +244,7 @@ httplib::Server::HandlerResponse Server::authenticate_request(const httplib::Req
 void Server::setup_routes(httplib::Server &web_server) {
     // Add pre-routing handler to log ALL incoming requests (except health checks)
     web_server.set_pre_routing_handler([this](const httplib::Request& req, httplib::Response& res) {
-        this->log_request(req);
+        this->log_request(req, res);
         return authenticate_request(req, res);
     });
 
@@ -326,6 +403,11 @@ void Server::setup_routes(httplib::Server &web_server) {
         handle_system_stats(req, res);
     });
 
+    // Request tracing (Chrome trace or OTLP-JSON)
+    register_get("debug/trace", [this](const httplib::Request& req, httplib::Response& res) {
+        handle_debug_trace(req, res);
+    });
+
     register_post("log-level", [this](const httplib::Request& req, httplib::Response& res) {
         handle_log_level(req, res);
     });
@@ -457,22 +539,15 @@ void Server::setup_static_files(httplib::Server &web_server) {
 
     // Check if web app directory exists
     if (fs::exists(web_app_dir) && fs::is_directory(web_app_dir)) {
-        // Create a handler for serving web app index.html for SPA routing
-        auto serve_web_app_html = [web_app_dir](const httplib::Request&, httplib::Response& res) {
-            std::string index_path = web_app_dir + "/index.html";
-            std::ifstream file(index_path);
-
-            if (!file.is_open()) {
-                res.status = 404;
-                res.set_content("{\"error\": \"Web app not found\"}", "application/json");
-                return;
-            }
-
-            std::string html((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-            file.close();
-
-            // Inject mock API for web compatibility with Electron app code
-            std::string mock_api = R"(
+        // Files are cached in memory with ETags and precompressed variants; the listeners
+        // for IPv4 and IPv6 share one cache
+        if (!web_app_assets_) {
+            web_app_assets_ = std::make_shared<StaticAssetCache>(web_app_dir);
+
+            // index.html gets the mock API injected once, when it is (re)loaded, not on every hit
+            web_app_assets_->set_transform("index.html", [](std::string html) {
+                // Inject mock API for web compatibility with Electron app code
+                static const char* mock_api = R"(
 <script>
 // Mock Electron API for web compatibility
 window.api = {
@@ -622,17 +697,21 @@ window.api = {
 </script>
 )";
 
-            // Insert mock API before the closing </head> tag
-            size_t head_end_pos = html.find("</head>");
-            if (head_end_pos != std::string::npos) {
-                html.insert(head_end_pos, mock_api);
-            }
+                // Insert mock API before the closing </head> tag
+                size_t head_end_pos = html.find("</head>");
+                if (head_end_pos != std::string::npos) {
+                    html.insert(head_end_pos, mock_api);
+                }
+                return html;
+            });
+            web_app_assets_->warm("index.html");
+        }
+        auto assets = web_app_assets_;
 
-            // Set no-cache headers
-            res.set_header("Cache-Control", "no-cache, no-store, must-revalidate");
-            res.set_header("Pragma", "no-cache");
-            res.set_header("Expires", "0");
-            res.set_content(html, "text/html");
+        // Create a handler for serving web app index.html for SPA routing
+        // (served with an ETag and no-cache, so browsers revalidate with a cheap 304)
+        auto serve_web_app_html = [assets](const httplib::Request& req, httplib::Response& res) {
+            assets->serve(req, res, "index.html");
         };
 
         // Serve the web app's index.html at root and for SPA routes
@@ -643,40 +722,8 @@ window.api = {
 
         // Serve all static assets from the web app directory (JS, CSS, fonts, assets, etc.)
         // Handle both root-level assets and /web-app/ prefixed paths for backwards compatibility
-        auto serve_web_app_asset = [web_app_dir](const httplib::Request& req, httplib::Response& res, const std::string& file_path) {
-            std::string full_path = web_app_dir + "/" + file_path;
-
-            // Serve the file
-            std::ifstream file(full_path, std::ios::binary);
-            if (!file.is_open()) {
-                res.status = 404;
-                res.set_content("File not found", "text/plain");
-                return;
-            }
-
-            // Read file content
-            std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-            file.close();
-
-            // Determine content type based on extension
-            std::string content_type = "application/octet-stream";
-            size_t dot_pos = file_path.rfind('.');
-            if (dot_pos != std::string::npos) {
-                std::string ext = file_path.substr(dot_pos);
-                if (ext == ".js") content_type = "text/javascript";
-                else if (ext == ".css") content_type = "text/css";
-                else if (ext == ".html") content_type = "text/html";
-                else if (ext == ".woff") content_type = "font/woff";
-                else if (ext == ".woff2") content_type = "font/woff2";
-                else if (ext == ".ttf") content_type = "font/ttf";
-                else if (ext == ".svg") content_type = "image/svg+xml";
-                else if (ext == ".png") content_type = "image/png";
-                else if (ext == ".jpg" || ext == ".jpeg") content_type = "image/jpeg";
-                else if (ext == ".json") content_type = "application/json";
-                else if (ext == ".ico") content_type = "image/x-icon";
-            }
-
-            res.set_content(content, content_type);
+        auto serve_web_app_asset = [assets](const httplib::Request& req, httplib::Response& res, const std::string& file_path) {
+            assets->serve(req, res, file_path);
         };
 
         // Serve favicon from web-app directory at root
@@ -684,7 +731,7 @@ window.api = {
             serve_web_app_asset(req, res, "favicon.ico");
         });
 
-        // Serve web app assets from root (for files like renderer.bundle.js, fonts, etc.)
+        // Serve web app assets from root (for files like renderer.<contenthash>.js, fonts, etc.)
         web_server.Get(R"(/([^/]+\.(js|css|woff|woff2|ttf|svg|png|jpg|jpeg|json|ico)))",
                       [serve_web_app_asset](const httplib::Request& req, httplib::Response& res) {
             std::string file_path = req.matches[1].str();
@@ -758,7 +805,7 @@ void Server::setup_cors(httplib::Server &web_server) {
     web_server.set_default_headers({
         {"Access-Control-Allow-Origin", "*"},
         {"Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS"},
-        {"Access-Control-Allow-Headers", "Content-Type, Authorization"}
+        {"Access-Control-Allow-Headers", "Content-Type, Authorization, X-Lemonade-Priority"}
     });
 
     // Handle preflight OPTIONS requests
@@ -844,13 +891,11 @@ std::string Server::resolve_host_to_ip(int ai_family, const std::string& host) {
 void Server::setup_http_logger(httplib::Server &web_server) {
     // Add request logging for ALL requests (except health checks and stats endpoints)
     web_server.set_logger([this](const httplib::Request& req, const httplib::Response& res) {
+        // Close the request span opened in log_request (runs after streamed bodies finish)
+        tracing::end_request(req.method + " " + req.path + " " + std::to_string(res.status));
+
         // Skip logging health checks and stats endpoints to reduce log noise
-        if (req.path == "/api/v0/health" || req.path == "/api/v1/health" ||
-            req.path == "/v0/health" || req.path == "/v1/health" || req.path == "/live" ||
-            req.path == "/api/v0/system-stats" || req.path == "/api/v1/system-stats" ||
-            req.path == "/v0/system-stats" || req.path == "/v1/system-stats" ||
-            req.path == "/api/v0/stats" || req.path == "/api/v1/stats" ||
-            req.path == "/v0/stats" || req.path == "/v1/stats") {
+        if (is_polling_endpoint(req.path)) {
             return;
         }
 
@@ -932,6 +977,44 @@ void Server::run() {
         });
     }
 
+#ifndef _WIN32
+    if (http_server_unix_) {
+        if (utils::is_unix_socket_listening(unix_socket_path_)) {
+            LOG(WARNING, "Server") << "Unix socket " << unix_socket_path_
+                                   << " is in use by another instance, not listening on it" << std::endl;
+        } else {
+            // Left behind by an instance that did not shut down cleanly. Only ever delete a
+            // socket: the path may be user-supplied and point at a regular file.
+            struct stat st;
+            bool path_free = lstat(unix_socket_path_.c_str(), &st) != 0;
+            if (!path_free && S_ISSOCK(st.st_mode)) {
+                path_free = std::remove(unix_socket_path_.c_str()) == 0;
+            }
+
+            if (!path_free) {
+                LOG(WARNING, "Server") << unix_socket_path_
+                                       << " exists and is not a stale socket, not listening on it" << std::endl;
+            } else {
+                setup_http_logger(*http_server_unix_);
+                http_unix_thread_ = std::thread([this]() {
+                    // Create the socket owner-only from the start instead of chmod-ing it after
+                    // bind(), which would leave it connectable by others for a moment
+                    mode_t previous_umask = umask(0077);
+                    bool bound = http_server_unix_->bind_to_port(unix_socket_path_, port_);
+                    umask(previous_umask);
+                    if (!bound) {
+                        LOG(WARNING, "Server") << "Failed to listen on Unix socket " << unix_socket_path_ << std::endl;
+                        return;
+                    }
+                    unix_socket_listening_ = true;
+                    LOG(INFO, "Server") << "Listening on Unix socket " << unix_socket_path_ << std::endl;
+                    http_server_unix_->listen_after_bind();
+                });
+            }
+        }
+    }
+#endif
+
     //Enumerate all RFC1918 interfaces to determine if we can broadcast.
     //The beacon will send per-interface with the correct IP in the payload.
     auto rfc1918Interfaces = udp_beacon_.getLocalRFC1918Interfaces();
@@ -966,6 +1049,9 @@ void Server::run() {
                   << host_ << ":" << port_ << ". Duplicate instance now exiting." << std::endl;
         stop();
     }
+
+    if (http_unix_thread_.joinable())
+        http_unix_thread_.join();
 }
 
 void Server::stop() {
@@ -974,6 +1060,12 @@ void Server::stop() {
         udp_beacon_.stopBroadcasting();
         http_server_v6_->stop();
         http_server_->stop();
+        if (http_server_unix_) {
+            http_server_unix_->stop();
+            if (unix_socket_listening_.exchange(false)) {
+                std::remove(unix_socket_path_.c_str());
+            }
+        }
         running_ = false;
 
 #ifdef LEMON_HAS_WEBSOCKET
@@ -1127,6 +1219,7 @@ void Server::auto_load_model_if_needed(const std::string& requested_model) {
         throw std::runtime_error("Model not found: " + requested_model);
     }
 
+    tracing::Span span("auto_load", requested_model);
     auto info = model_manager_->get_model_info(requested_model);
 
     // Download model if not cached (first-time use)
@@ -1182,13 +1275,29 @@ void Server::handle_health(const httplib::Request& req, httplib::Response& res)
         {"websocket", false}  // WebSocket support not yet implemented
     };
 
+    // HTTP worker saturation (busy workers vs. pool limits) and connection reuse, per listener
+    response["http_workers"] = {
+        {"ipv4", http_pool_->get_stats()},
+        {"ipv6", http_pool_v6_->get_stats()}
+    };
+    if (unix_socket_listening_) {
+        response["http_workers"]["unix"] = http_pool_unix_->get_stats();
+        response["unix_socket"] = unix_socket_path_;
+    }
+
+    // Proxied backend streams and clients dropped for not reading
+    response["streaming"] = StreamingProxy::get_stats();
+
 #ifdef LEMON_HAS_WEBSOCKET
     // Add WebSocket server port for realtime API
     if (websocket_server_ && websocket_server_->is_running()) {
         response["websocket_port"] = websocket_server_->get_port();
+        response["realtime"] = websocket_server_->get_stats();
     }
 #endif
 
+    response["tts_cache"] = router_->get_speech_cache_stats();
+
     res.set_content(response.dump(), "application/json");
 }
 
@@ -1216,24 +1325,34 @@ void Server::handle_models(const httplib::Request& req, httplib::Response& res)
     // Check if we should show all models (for CLI list command) or only downloaded (OpenAI API behavior)
     bool show_all = req.has_param("show_all") && req.get_param_value("show_all") == "true";
 
-    // OPTIMIZATION: For OpenAI API mode, use get_downloaded_models() which filters first
-    // Only use get_supported_models() when we need to show ALL models
-    std::map<std::string, ModelInfo> models;
-    if (show_all) {
-        models = model_manager_->get_supported_models();
-    } else {
-        models = model_manager_->get_downloaded_models();
-    }
-
-    nlohmann::json response;
-    response["data"] = nlohmann::json::array();
-    response["object"] = "list";
+    // The serialized list is cached per cache version and shared by every poller;
+    // it is only rebuilt after a model is added, removed, downloaded or reconfigured
+    uint64_t version = 0;
+    ModelSnapshot snapshot = model_manager_->get_models_snapshot(&version);
+
+    std::shared_ptr<http_compression::CachedBody> body;
+    {
+        std::lock_guard<std::mutex> lock(models_response_mutex_);
+        auto& cached = models_response_[show_all ? 1 : 0];
+        if (!cached.body || cached.version != version) {
+            nlohmann::json response;
+            response["data"] = nlohmann::json::array();
+            response["object"] = "list";
+
+            // OpenAI API mode only lists downloaded models
+            for (const auto& [model_id, model_info] : *snapshot) {
+                if (show_all || model_info.downloaded) {
+                    response["data"].push_back(model_info_to_json(model_id, model_info));
+                }
+            }
 
-    for (const auto& [model_id, model_info] : models) {
-        response["data"].push_back(model_info_to_json(model_id, model_info));
+            cached.version = version;
+            cached.body = std::make_shared<http_compression::CachedBody>(response.dump(), "application/json");
+        }
+        body = cached.body;
     }
 
-    res.set_content(response.dump(), "application/json");
+    body->send(req, res);
 }
 
 nlohmann::json Server::model_info_to_json(const std::string& model_id, const ModelInfo& info) {
@@ -1285,14 +1404,25 @@ void Server::handle_model_by_id(const httplib::Request& req, httplib::Response&
 
 void Server::handle_chat_completions(const httplib::Request& req, httplib::Response& res) {
     try {
-        auto request_json = nlohmann::json::parse(req.body);
-
-        // Debug: Check if tools are present
-        if (request_json.contains("tools")) {
-            LOG(DEBUG, "Server") << "Tools present in request: " << request_json["tools"].size() << " tool(s)" << std::endl;
-            LOG(DEBUG, "Server") << "Tools JSON: " << request_json["tools"].dump() << std::endl;
-        } else {
-            LOG(DEBUG, "Server") << "No tools in request" << std::endl;
+        // Streams are routed on the top-level fields alone, read by a SAX scan. The body is
+        // parsed into a DOM only when the response is built here or the messages are rewritten.
+        auto request_json = utils::JsonUtils::scan_fields(
+            req.body, {"model", "stream", "enable_thinking", "max_completion_tokens", "max_tokens"});
+        bool is_streaming = request_json.contains("stream") && request_json["stream"].get<bool>();
+        bool disable_thinking = request_json.contains("enable_thinking") &&
+                                request_json["enable_thinking"].is_boolean() &&
+                                request_json["enable_thinking"].get<bool>() == false;
+        bool parsed = !is_streaming || disable_thinking;
+        if (parsed) {
+            request_json = nlohmann::json::parse(req.body);
+
+            // Debug: Check if tools are present
+            if (request_json.contains("tools")) {
+                LOG(DEBUG, "Server") << "Tools present in request: " << request_json["tools"].size() << " tool(s)" << std::endl;
+                LOG(DEBUG, "Server") << "Tools JSON: " << request_json["tools"].dump() << std::endl;
+            } else {
+                LOG(DEBUG, "Server") << "No tools in request" << std::endl;
+            }
         }
 
         // Handle model loading/switching
@@ -1329,19 +1459,12 @@ void Server::handle_chat_completions(const httplib::Request& req, httplib::Respo
             return;
         }
 
-        // Check if streaming is requested
-        bool is_streaming = request_json.contains("stream") && request_json["stream"].get<bool>();
-
-        // Use original request body - each backend (FLM, llamacpp, etc.) handles
-        // model name transformation internally via their forward methods
-        std::string request_body = req.body;
+        // Streams forward the original request body unless it has to change below - each
+        // backend (FLM, llamacpp, etc.) handles model name transformation internally
         bool request_modified = false;
 
         // Handle enable_thinking=false by prepending /no_think to last user message
-        if (request_json.contains("enable_thinking") &&
-            request_json["enable_thinking"].is_boolean() &&
-            request_json["enable_thinking"].get<bool>() == false) {
-
+        if (disable_thinking) {
             if (request_json.contains("messages") && request_json["messages"].is_array()) {
                 auto& messages = request_json["messages"];
 
@@ -1364,12 +1487,21 @@ void Server::handle_chat_completions(const httplib::Request& req, httplib::Respo
             }
         }
 
-        // If we modified the request, serialize it back to string
-        if (request_modified) {
-            request_body = request_json.dump();
+        if (utils::JsonUtils::needs_max_tokens(request_json)) {
+            request_json["max_tokens"] = request_json["max_completion_tokens"];
+            request_modified = true;
         }
 
         if (is_streaming) {
+            // A parsed request is serialized again; max_tokens alone is spliced into the original bytes
+            std::string modified_body;
+            if (request_modified && parsed) {
+                modified_body = request_json.dump();
+            } else if (request_modified) {
+                modified_body = req.body;
+                utils::JsonUtils::insert_field(modified_body, "max_tokens", request_json["max_tokens"]);
+            }
+
             try {
                 // Log the HTTP request
                 LOG(INFO, "Server") << "POST /api/v1/chat/completions - Streaming" << std::endl;
@@ -1383,15 +1515,17 @@ void Server::handle_chat_completions(const httplib::Request& req, httplib::Respo
                 // Use cpp-httplib's chunked content provider for SSE streaming
                 res.set_chunked_content_provider(
                     "text/event-stream",
-                    [this, request_body](size_t offset, httplib::DataSink& sink) {
+                    [this, &req, model = model_to_check, request_modified,
+                     modified_body = std::move(modified_body)](size_t offset, httplib::DataSink& sink) {
                         // For chunked responses, offset tracks bytes sent so far
                         // We only want to stream once when offset is 0
                         if (offset > 0) {
                             return false; // We're done after the first call
                         }
 
-                        // Use unified Router path for streaming
-                        router_->chat_completion_stream(request_body, sink);
+                        // Use unified Router path for streaming. req outlives the provider:
+                        // httplib writes the response before the request is destroyed.
+                        router_->chat_completion_stream(model, request_modified ? modified_body : req.body, sink);
 
                         return false;
                     }
@@ -1453,10 +1587,18 @@ void Server::handle_chat_completions(const httplib::Request& req, httplib::Respo
                     LOG(INFO, "Telemetry") << "TPS:           " << std::fixed << std::setprecision(2)
                              << tps << std::endl;
                 }
+                int draft_tokens = timings.value("draft_n", 0);
+                int draft_tokens_accepted = timings.value("draft_n_accepted", 0);
+                if (draft_tokens > 0) {
+                    LOG(INFO, "Telemetry") << "Draft accept:  " << draft_tokens_accepted << "/" << draft_tokens
+                             << " (" << std::fixed << std::setprecision(1)
+                             << (100.0 * draft_tokens_accepted / draft_tokens) << "%)" << std::endl;
+                }
                 LOG(INFO, "Telemetry") << "=================" << std::endl;
 
                 // Save telemetry to router
                 router_->update_telemetry(input_tokens, output_tokens, ttft_seconds, tps);
+                router_->update_draft_telemetry(draft_tokens, draft_tokens_accepted);
             } else if (response.contains("usage")) {
                 // OpenAI format uses "usage" field
                 auto usage = response["usage"];
@@ -1512,7 +1654,13 @@ void Server::handle_chat_completions(const httplib::Request& req, httplib::Respo
 
 void Server::handle_completions(const httplib::Request& req, httplib::Response& res) {
     try {
-        auto request_json = nlohmann::json::parse(req.body);
+        // As for chat completions, streams are routed on a SAX scan of the top-level fields
+        auto request_json = utils::JsonUtils::scan_fields(
+            req.body, {"model", "stream", "max_completion_tokens", "max_tokens"});
+        bool is_streaming = request_json.contains("stream") && request_json["stream"].get<bool>();
+        if (!is_streaming) {
+            request_json = nlohmann::json::parse(req.body);
+        }
 
         // Handle model loading/switching (same logic as chat_completions)
         if (request_json.contains("model")) {
@@ -1548,13 +1696,21 @@ void Server::handle_completions(const httplib::Request& req, httplib::Response&
             return;
         }
 
-        // Check if streaming is requested
-        bool is_streaming = request_json.contains("stream") && request_json["stream"].get<bool>();
-
-        // Use original request body - each backend handles model name transformation internally
-        std::string request_body = req.body;
+        // Streams forward the original request body unless max_tokens has to be added - each
+        // backend handles model name transformation internally
+        bool request_modified = false;
+        if (utils::JsonUtils::needs_max_tokens(request_json)) {
+            request_json["max_tokens"] = request_json["max_completion_tokens"];
+            request_modified = true;
+        }
 
         if (is_streaming) {
+            std::string modified_body;
+            if (request_modified) {
+                modified_body = req.body;
+                utils::JsonUtils::insert_field(modified_body, "max_tokens", request_json["max_tokens"]);
+            }
+
             try {
                 // Log the HTTP request
                 LOG(INFO, "Server") << "POST /api/v1/completions - Streaming" << std::endl;
@@ -1567,13 +1723,14 @@ void Server::handle_completions(const httplib::Request& req, httplib::Response&
 
                 res.set_chunked_content_provider(
                     "text/event-stream",
-                    [this, request_body](size_t offset, httplib::DataSink& sink) {
+                    [this, &req, model = model_to_check, request_modified,
+                     modified_body = std::move(modified_body)](size_t offset, httplib::DataSink& sink) {
                         if (offset > 0) {
                             return false; // Already sent everything
                         }
 
-                        // Use unified Router path for streaming
-                        router_->completion_stream(request_body, sink);
+                        // Use unified Router path for streaming (req outlives the provider)
+                        router_->completion_stream(model, request_modified ? modified_body : req.body, sink);
 
                         return false;
                     }
@@ -1638,10 +1795,18 @@ void Server::handle_completions(const httplib::Request& req, httplib::Response&
                     LOG(INFO, "Telemetry") << "TPS:           " << std::fixed << std::setprecision(2)
                              << tps << std::endl;
                 }
+                int draft_tokens = timings.value("draft_n", 0);
+                int draft_tokens_accepted = timings.value("draft_n_accepted", 0);
+                if (draft_tokens > 0) {
+                    LOG(INFO, "Telemetry") << "Draft accept:  " << draft_tokens_accepted << "/" << draft_tokens
+                             << " (" << std::fixed << std::setprecision(1)
+                             << (100.0 * draft_tokens_accepted / draft_tokens) << "%)" << std::endl;
+                }
                 LOG(INFO, "Telemetry") << "=================" << std::endl;
 
                 // Save telemetry to router
                 router_->update_telemetry(input_tokens, output_tokens, ttft_seconds, tps);
+                router_->update_draft_telemetry(draft_tokens, draft_tokens_accepted);
             } else if (response.contains("usage")) {
                 auto usage = response["usage"];
                 int input_tokens = 0;
@@ -1800,23 +1965,16 @@ void Server::handle_audio_transcriptions(const httplib::Request& req, httplib::R
         if (req.form.has_field("temperature")) {
             request_json["temperature"] = std::stod(req.form.get_field("temperature"));
         }
-
-        // Extract audio file
-        const auto& files = req.form.files;
-        bool found_audio = false;
-        for (const auto& file_pair : files) {
-            if (file_pair.first == "file") {
-                const auto& file = file_pair.second;
-                request_json["file_data"] = file.content;
-                request_json["filename"] = file.filename;
-                found_audio = true;
-                LOG(INFO, "Server") << "Audio file: " << file.filename
-                          << " (" << file.content.size() << " bytes)" << std::endl;
-                break;
-            }
+        if (req.form.has_field("chunking_strategy")) {
+            // "auto" or a JSON object such as {"type": "server_vad"}
+            std::string strategy = req.form.get_field("chunking_strategy");
+            auto parsed = nlohmann::json::parse(strategy, nullptr, false);
+            request_json["chunking_strategy"] = parsed.is_object() ? parsed : nlohmann::json(strategy);
         }
 
-        if (!found_audio) {
+        // Extract audio file (copied once out of the request; shared from here to the backend)
+        auto file_it = req.form.files.find("file");
+        if (file_it == req.form.files.end()) {
             res.status = 400;
             nlohmann::json error = {{"error", {
                 {"message", "Missing 'file' field in request"},
@@ -1826,6 +1984,11 @@ void Server::handle_audio_transcriptions(const httplib::Request& req, httplib::R
             return;
         }
 
+        const auto& file = file_it->second;
+        audio::AudioPayload audio(file.content, file.filename);
+        LOG(INFO, "Server") << "Audio file: " << file.filename
+                  << " (" << file.content.size() << " bytes)" << std::endl;
+
         // Handle model loading
         if (request_json.contains("model")) {
             std::string requested_model = request_json["model"];
@@ -1850,7 +2013,7 @@ void Server::handle_audio_transcriptions(const httplib::Request& req, httplib::R
         }
 
         // Forward to router
-        auto response = router_->audio_transcriptions(request_json);
+        auto response = router_->audio_transcriptions(request_json, audio);
 
         // Check for error in response
         if (response.contains("error")) {
@@ -1897,7 +2060,44 @@ void Server::handle_audio_speech(const httplib::Request& req, httplib::Response&
             return;
         }
 
-        if (!request_json.contains("input")) {
+        // Speech from a chat completion: the LLM's answer is spoken sentence by sentence
+        // while it is being generated
+        nlohmann::json chat_request;
+        if (request_json.contains("chat")) {
+            chat_request = request_json["chat"];
+            request_json.erase("chat");
+            if (!chat_request.is_object() || !chat_request.contains("model") ||
+                !chat_request["model"].is_string() || !chat_request.contains("messages")) {
+                res.status = 400;
+                nlohmann::json error = {{"error", {
+                    {"message", "'chat' must be a chat completion request with 'model' and 'messages'"},
+                    {"type", "invalid_request_error"}
+                }}};
+                res.set_content(error.dump(), "application/json");
+                return;
+            }
+
+            std::string chat_model = chat_request["model"].get<std::string>();
+            try {
+                auto_load_model_if_needed(chat_model);
+            } catch (const std::exception& e) {
+                LOG(ERROR, "Server") << "Failed to load chat model: " << e.what() << std::endl;
+                auto error_response = create_model_error(chat_model, e.what());
+                std::string error_code = error_response["error"]["code"].get<std::string>();
+                res.status = (error_code == "model_load_error") ? 500 : 404;
+                res.set_content(error_response.dump(), "application/json");
+                return;
+            }
+            if (router_->get_model_type(chat_model) != ModelType::LLM) {
+                res.status = 400;
+                nlohmann::json error = {{"error", {
+                    {"message", "The 'chat' model does not support chat completion"},
+                    {"type", "invalid_request_error"}
+                }}};
+                res.set_content(error.dump(), "application/json");
+                return;
+            }
+        } else if (!request_json.contains("input")) {
             res.status = 400;
             nlohmann::json error = {{"error", {
                 {"message", "Missing 'input' field in request"},
@@ -1907,7 +2107,8 @@ void Server::handle_audio_speech(const httplib::Request& req, httplib::Response&
             return;
         }
 
-        bool is_streaming = (request_json.contains("stream") && request_json["stream"].get<bool>());
+        bool is_streaming = (request_json.contains("stream") && request_json["stream"].get<bool>()) ||
+                            !chat_request.is_null();
 
         if (request_json.contains("stream_format")) {
             is_streaming = true;
@@ -1945,7 +2146,7 @@ void Server::handle_audio_speech(const httplib::Request& req, httplib::Response&
 
         res.set_header("Content-Type", mime_type);
 
-        auto audio_source = [this, request_json](size_t offset, httplib::DataSink& sink) {
+        auto audio_source = [this, request_json, chat_request](size_t offset, httplib::DataSink& sink) {
             // For chunked responses, offset tracks bytes sent so far
             // We only want to stream once when offset is 0
             if (offset > 0) {
@@ -1953,7 +2154,11 @@ void Server::handle_audio_speech(const httplib::Request& req, httplib::Response&
             }
 
             // Use unified Router path for streaming
-            router_->audio_speech(request_json, sink);
+            if (chat_request.is_null()) {
+                router_->audio_speech(request_json, sink);
+            } else {
+                router_->audio_speech_from_chat(request_json, chat_request, sink);
+            }
 
             return false;
         };
@@ -2029,7 +2234,7 @@ void Server::handle_image_generations(const httplib::Request& req, httplib::Resp
             res.status = 500;
         }
 
-        res.set_content(response.dump(), "application/json");
+        http_compression::send_compressed(req, res, response.dump(), "application/json");
 
     } catch (const nlohmann::json::exception& e) {
         LOG(ERROR, "Server") << "JSON parse error in handle_image_generations: " << e.what() << std::endl;
@@ -2247,7 +2452,7 @@ void Server::handle_image_edits(const httplib::Request& req, httplib::Response&
             LOG(ERROR, "Server") << "Image edits backend error: " << response.dump() << std::endl;
             res.status = 500;
         }
-        res.set_content(response.dump(), "application/json");
+        http_compression::send_compressed(req, res, response.dump(), "application/json");
 
     } catch (const nlohmann::json::exception& e) {
         LOG(ERROR, "Server") << "JSON parse error in handle_image_edits: " << e.what() << std::endl;
@@ -2299,7 +2504,7 @@ void Server::handle_image_variations(const httplib::Request& req, httplib::Respo
             LOG(ERROR, "Server") << "Image variations backend error: " << response.dump() << std::endl;
             res.status = 500;
         }
-        res.set_content(response.dump(), "application/json");
+        http_compression::send_compressed(req, res, response.dump(), "application/json");
 
     } catch (const nlohmann::json::exception& e) {
         LOG(ERROR, "Server") << "JSON parse error in handle_image_variations: " << e.what() << std::endl;
@@ -2360,13 +2565,13 @@ void Server::handle_responses(const httplib::Request& req, httplib::Response& re
                 // Use cpp-httplib's chunked content provider for SSE streaming
                 res.set_chunked_content_provider(
                     "text/event-stream",
-                    [this, request_body = req.body](size_t offset, httplib::DataSink& sink) {
+                    [this, &req, model = request_json.value("model", "")](size_t offset, httplib::DataSink& sink) {
                         if (offset > 0) {
                             return false; // Only stream once
                         }
 
-                        // Use unified Router path for streaming
-                        router_->responses_stream(request_body, sink);
+                        // Use unified Router path for streaming (req outlives the provider)
+                        router_->responses_stream(model, req.body, sink);
 
                         return false;
                     }
@@ -2838,6 +3043,35 @@ void Server::handle_stats(const httplib::Request& req, httplib::Response& res) {
     }
 }
 
+void Server::handle_debug_trace(const httplib::Request& req, httplib::Response& res) {
+    try {
+        uint64_t request_id = 0;
+        if (req.has_param("request_id")) {
+            request_id = std::stoull(req.get_param_value("request_id"));
+        }
+
+        std::string format = req.has_param("format") ? req.get_param_value("format") : "chrome";
+        nlohmann::json trace;
+        if (format == "chrome") {
+            trace = tracing::export_chrome_trace(request_id);
+        } else if (format == "otlp") {
+            trace = tracing::export_otlp(request_id);
+        } else {
+            res.status = 400;
+            nlohmann::json error = {{"error", "Unsupported trace format '" + format + "' (use 'chrome' or 'otlp')"}};
+            res.set_content(error.dump(), "application/json");
+            return;
+        }
+
+        http_compression::send_compressed(req, res, trace.dump(), "application/json");
+    } catch (const std::exception& e) {
+        LOG(ERROR, "Server") << "ERROR in handle_debug_trace: " << e.what() << std::endl;
+        res.status = 400;
+        nlohmann::json error = {{"error", e.what()}};
+        res.set_content(error.dump(), "application/json");
+    }
+}
+
 void Server::handle_system_info(const httplib::Request& req, httplib::Response& res) {
     // For HEAD requests, just return 200 OK without processing
     if (req.method == "HEAD") {
@@ -2854,7 +3088,7 @@ void Server::handle_system_info(const httplib::Request& req, httplib::Response&
         enrich_recipes(system_info["recipes"]);
     }
 
-    res.set_content(system_info.dump(), "application/json");
+    http_compression::send_compressed(req, res, system_info.dump(), "application/json");
 }
 
 // Get CPU usage percentage
@@ -0,0 +1,239 @@
+#include "lemon/speech_cache.h"
+#include "lemon/utils/hash_utils.h"
+#include <lemon/utils/aixlog.hpp>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace lemon {
+
+static const char* ENTRY_EXTENSION = ".tts";
+
+void SpeechCache::configure(const std::string& dir, uint64_t budget_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dir_ = fs::path(dir);
+    budget_bytes_ = budget_bytes;
+    total_bytes_ = 0;
+    lru_.clear();
+    entries_.clear();
+
+    if (budget_bytes_ == 0) {
+        return;
+    }
+
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    if (ec) {
+        LOG(WARNING, "SpeechCache") << "Could not create speech cache directory " << dir_.string()
+                                    << ": " << ec.message() << std::endl;
+        budget_bytes_ = 0;
+        return;
+    }
+
+    // Pick up entries from earlier runs, most recently used first
+    std::vector<std::pair<fs::file_time_type, fs::directory_entry>> files;
+    for (const auto& entry : fs::directory_iterator(dir_, ec)) {
+        if (!entry.is_regular_file(ec)) {
+            continue;
+        }
+        if (entry.path().extension() == ENTRY_EXTENSION) {
+            files.emplace_back(entry.last_write_time(ec), entry);
+        } else if (entry.path().extension() == ".tmp") {
+            fs::remove(entry.path(), ec);  // Interrupted write
+        }
+    }
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    for (const auto& file : files) {
+        std::string name = file.second.path().filename().string();
+        uint64_t size = file.second.file_size(ec);
+        lru_.push_back(name);
+        entries_[name] = {std::prev(lru_.end()), size};
+        total_bytes_ += size;
+    }
+    evict_over_budget();
+
+    LOG(DEBUG, "SpeechCache") << "Speech cache at " << dir_.string() << ": " << entries_.size()
+                              << " entries, " << total_bytes_ << " of " << budget_bytes_ << " bytes" << std::endl;
+}
+
+bool SpeechCache::enabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_bytes_ > 0;
+}
+
+std::string SpeechCache::request_key(const json& request) {
+    if (!request.contains("input") || !request["input"].is_string()) {
+        return "";
+    }
+
+    // Everything that shapes the audio except the text: model, voice, speed and any other
+    // option, plus the delivered format (a stream is always raw PCM)
+    bool streaming = request.contains("stream_format") ||
+                     (request.contains("stream") && request["stream"].is_boolean() && request["stream"].get<bool>());
+    json identity = request;
+    identity.erase("input");
+    identity.erase("stream");
+    identity.erase("stream_format");
+    identity.erase("response_format");
+    identity["format"] = streaming ? "pcm_stream" : request.value("response_format", "mp3");
+
+    return identity.dump() + "\n" + request["input"].get_ref<const std::string&>();
+}
+
+std::string SpeechCache::file_name(const std::string& key) {
+    return utils::fnv1a_64_hex(key) + ENTRY_EXTENSION;
+}
+
+bool SpeechCache::replay(const std::string& key, httplib::DataSink& sink) {
+    std::string name = file_name(key);
+    fs::path path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (budget_bytes_ == 0) {
+            return false;
+        }
+        if (entries_.find(name) == entries_.end()) {
+            misses_++;
+            return false;
+        }
+        path = dir_ / name;
+    }
+
+    // Entry layout: key length (uint32, little endian), key, audio
+    std::ifstream file(path, std::ios::binary);
+    unsigned char length_bytes[4] = {};
+    file.read(reinterpret_cast<char*>(length_bytes), sizeof(length_bytes));
+    uint32_t key_length = length_bytes[0] | (length_bytes[1] << 8) | (length_bytes[2] << 16) |
+                          (static_cast<uint32_t>(length_bytes[3]) << 24);
+    std::string stored_key;
+    if (file && key_length == key.size()) {
+        stored_key.resize(key_length);
+        file.read(&stored_key[0], key_length);
+    }
+
+    if (!file || stored_key != key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        misses_++;
+        forget(name);  // Missing, truncated or a hash collision
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hits_++;
+        touch(name);
+    }
+
+    std::vector<char> chunk(REPLAY_CHUNK_BYTES);
+    while (file.read(chunk.data(), chunk.size()) || file.gcount() > 0) {
+        if (!sink.write(chunk.data(), static_cast<size_t>(file.gcount()))) {
+            break;  // Client disconnected
+        }
+    }
+    return true;
+}
+
+void SpeechCache::store(const std::string& key, const std::string& audio) {
+    uint64_t size = 4 + key.size() + audio.size();
+    fs::path dir;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (budget_bytes_ == 0 || size > budget_bytes_ / 4) {
+            return;
+        }
+        dir = dir_;
+    }
+
+    // Failures reach the stream as an SSE or JSON error instead of audio
+    if (audio.empty() || audio.compare(0, 5, "data:") == 0 || audio[0] == '{') {
+        return;
+    }
+
+    // Write under a unique temporary name, then rename so readers never see a partial file
+    static std::atomic<uint64_t> next_temp{0};
+    std::string name = file_name(key);
+    fs::path temp_path = dir / (name + "." + std::to_string(next_temp++) + ".tmp");
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        unsigned char length_bytes[4] = {
+            static_cast<unsigned char>(key.size()), static_cast<unsigned char>(key.size() >> 8),
+            static_cast<unsigned char>(key.size() >> 16), static_cast<unsigned char>(key.size() >> 24)};
+        file.write(reinterpret_cast<const char*>(length_bytes), sizeof(length_bytes));
+        file.write(key.data(), key.size());
+        file.write(audio.data(), audio.size());
+        if (!file) {
+            LOG(WARNING, "SpeechCache") << "Could not write " << temp_path.string() << std::endl;
+            file.close();
+            std::error_code ec;
+            fs::remove(temp_path, ec);
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code ec;
+    fs::rename(temp_path, dir_ / name, ec);
+    if (ec) {
+        fs::remove(temp_path, ec);
+        return;
+    }
+
+    auto it = entries_.find(name);
+    if (it != entries_.end()) {
+        total_bytes_ -= it->second.size;
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+    }
+    lru_.push_front(name);
+    entries_[name] = {lru_.begin(), size};
+    total_bytes_ += size;
+    evict_over_budget();
+}
+
+json SpeechCache::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {
+        {"entries", entries_.size()},
+        {"bytes", total_bytes_},
+        {"budget_bytes", budget_bytes_},
+        {"hits", hits_},
+        {"misses", misses_}
+    };
+}
+
+void SpeechCache::touch(const std::string& name) {
+    auto it = entries_.find(name);
+    if (it == entries_.end()) {
+        return;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+
+    // Recency is kept in the file's modification time for the next start
+    std::error_code ec;
+    fs::last_write_time(dir_ / name, fs::file_time_type::clock::now(), ec);
+}
+
+void SpeechCache::forget(const std::string& name) {
+    auto it = entries_.find(name);
+    if (it != entries_.end()) {
+        total_bytes_ -= it->second.size;
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+    }
+    std::error_code ec;
+    fs::remove(dir_ / name, ec);
+}
+
+void SpeechCache::evict_over_budget() {
+    while (total_bytes_ > budget_bytes_ && !lru_.empty()) {
+        std::string name = lru_.back();
+        LOG(DEBUG, "SpeechCache") << "Evicting " << name << std::endl;
+        forget(name);
+    }
+}
+
+} // namespace lemon
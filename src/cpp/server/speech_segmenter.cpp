@@ -0,0 +1,218 @@
+#include "lemon/speech_segmenter.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace lemon {
+namespace audio {
+
+static const char* THINK_OPEN = "<think>";
+static const char* THINK_CLOSE = "</think>";
+
+// Words whose trailing period does not end a sentence
+static const char* ABBREVIATIONS[] = {"mr", "mrs", "ms", "dr", "prof", "st", "jr", "sr", "vs", "e.g", "i.e"};
+
+static bool is_space(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+static bool is_abbreviation(const std::string& text, size_t period) {
+    size_t start = period;
+    while (start > 0 && !is_space(text[start - 1])) {
+        start--;
+    }
+    std::string word = text.substr(start, period - start);
+    while (!word.empty() && std::strchr("\"'([", word.front())) {
+        word.erase(0, 1);
+    }
+
+    // Initials ("J. R. R. Tolkien")
+    if (word.size() == 1 && std::isupper(static_cast<unsigned char>(word[0]))) {
+        return true;
+    }
+    // Numbered list items ("1. Preheat the oven")
+    if (!word.empty() && (start == 0 || text[start - 1] == '\n') &&
+        std::all_of(word.begin(), word.end(), [](unsigned char c) { return std::isdigit(c) != 0; })) {
+        return true;
+    }
+    std::transform(word.begin(), word.end(), word.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (const char* abbreviation : ABBREVIATIONS) {
+        if (word == abbreviation) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SentenceSegmenter::push(const std::string& text) {
+    raw_ += text;
+
+    while (true) {
+        if (in_think_) {
+            size_t close = raw_.find(THINK_CLOSE);
+            if (close == std::string::npos) {
+                // Keep just enough to recognize a closing tag split across deltas
+                size_t keep = std::strlen(THINK_CLOSE) - 1;
+                if (raw_.size() > keep) {
+                    raw_.erase(0, raw_.size() - keep);
+                }
+                return;
+            }
+            raw_.erase(0, close + std::strlen(THINK_CLOSE));
+            in_think_ = false;
+            continue;
+        }
+
+        size_t open = raw_.find(THINK_OPEN);
+        size_t speakable = open;
+        if (open == std::string::npos) {
+            // Hold back a trailing "<thi..." that may become an opening tag
+            speakable = raw_.size();
+            size_t lt = raw_.rfind('<');
+            if (lt != std::string::npos && raw_.size() - lt < std::strlen(THINK_OPEN) &&
+                std::strncmp(THINK_OPEN, raw_.c_str() + lt, raw_.size() - lt) == 0) {
+                speakable = lt;
+            }
+        }
+
+        // Markdown emphasis, headings and code fences would be read out or mispronounced
+        for (size_t i = 0; i < speakable; i++) {
+            char c = raw_[i];
+            if (c != '*' && c != '#' && c != '`') {
+                pending_ += c;
+            }
+        }
+
+        if (open == std::string::npos) {
+            raw_.erase(0, speakable);
+            return;
+        }
+        raw_.erase(0, open + std::strlen(THINK_OPEN));
+        in_think_ = true;
+    }
+}
+
+size_t SentenceSegmenter::find_boundary() const {
+    size_t last_sentence = 0;
+    size_t last_clause = 0;
+    size_t last_space = 0;
+    const size_t limit = std::min(pending_.size(), Segmenting::MAX_CHARS);
+
+    for (size_t i = 0; i < limit; i++) {
+        unsigned char c = static_cast<unsigned char>(pending_[i]);
+        size_t end = 0;
+
+        if (c == '\n') {
+            end = i + 1;
+        } else if (c == '.' || c == '!' || c == '?') {
+            // Closing quotes and brackets belong to the sentence; a space must follow
+            size_t j = i + 1;
+            while (j < pending_.size() && std::strchr("\"')]", pending_[j])) {
+                j++;
+            }
+            if (j < pending_.size() && is_space(pending_[j]) &&
+                !(c == '.' && is_abbreviation(pending_, i))) {
+                end = j;
+            }
+        } else if (c == 0xE3 && i + 2 < pending_.size() &&
+                   static_cast<unsigned char>(pending_[i + 1]) == 0x80 &&
+                   static_cast<unsigned char>(pending_[i + 2]) == 0x82) {
+            end = i + 3;  // 。
+        } else if (c == 0xEF && i + 2 < pending_.size() &&
+                   static_cast<unsigned char>(pending_[i + 1]) == 0xBC &&
+                   (static_cast<unsigned char>(pending_[i + 2]) == 0x81 ||
+                    static_cast<unsigned char>(pending_[i + 2]) == 0x9F)) {
+            end = i + 3;  // ！ ？
+        } else if ((c == ',' || c == ';' || c == ':') && i + 1 < pending_.size() &&
+                   is_space(pending_[i + 1])) {
+            last_clause = i + 1;
+            if (first_ && last_clause >= Segmenting::FIRST_CLAUSE_CHARS) {
+                return last_clause;
+            }
+        } else if (is_space(static_cast<char>(c))) {
+            last_space = i;
+        }
+
+        if (end > 0) {
+            if (first_ || end >= Segmenting::MIN_CHARS) {
+                return end;
+            }
+            last_sentence = end;
+        }
+    }
+
+    if (pending_.size() < Segmenting::MAX_CHARS) {
+        return 0;
+    }
+
+    // Too long without a sentence end: cut at the best break seen so far
+    if (last_sentence > 0) {
+        return last_sentence;
+    }
+    if (last_clause > 0) {
+        return last_clause;
+    }
+    if (last_space > 0) {
+        return last_space;
+    }
+    size_t cut = Segmenting::MAX_CHARS;
+    while (cut > 0 && (static_cast<unsigned char>(pending_[cut]) & 0xC0) == 0x80) {
+        cut--;  // Don't split a UTF-8 sequence
+    }
+    return cut;
+}
+
+bool SentenceSegmenter::take(size_t end, std::string& sentence) {
+    std::string text = pending_.substr(0, end);
+    pending_.erase(0, end);
+
+    size_t first = 0;
+    while (first < text.size() && is_space(text[first])) {
+        first++;
+    }
+    size_t last = text.size();
+    while (last > first && is_space(text[last - 1])) {
+        last--;
+    }
+    text = text.substr(first, last - first);
+
+    // Skip pieces with nothing to pronounce (list bullets, stray punctuation)
+    bool speakable = std::any_of(text.begin(), text.end(), [](char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        return u >= 0x80 || std::isalnum(u);
+    });
+    if (!speakable) {
+        return false;
+    }
+
+    sentence = std::move(text);
+    first_ = false;
+    return true;
+}
+
+bool SentenceSegmenter::next(std::string& sentence) {
+    size_t end;
+    while ((end = find_boundary()) > 0) {
+        if (take(end, sentence)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SentenceSegmenter::flush(std::string& sentence) {
+    if (!in_think_) {
+        pending_ += raw_;
+    }
+    raw_.clear();
+    in_think_ = false;
+
+    if (next(sentence)) {
+        return true;
+    }
+    return take(pending_.size(), sentence);
+}
+
+} // namespace audio
+} // namespace lemon
@@ -0,0 +1,193 @@
+#include "lemon/static_asset_cache.h"
+#include "lemon/utils/hash_utils.h"
+#include "lemon/utils/path_utils.h"
+#include <lemon/utils/aixlog.hpp>
+#include <algorithm>
+#include <fstream>
+#include <regex>
+
+namespace fs = std::filesystem;
+
+namespace lemon {
+
+// Bundler output names such as renderer.1a2b3c4d.js or font.0123abcd.woff2
+static const std::regex HASHED_NAME(R"(\.[0-9a-f]{8,}\.[A-Za-z0-9]+$)");
+
+static std::string hash_etag(const std::string& content) {
+    return utils::fnv1a_64_hex(content) + "-" + std::to_string(content.size());
+}
+
+StaticAssetCache::StaticAssetCache(const std::string& root_dir)
+    : root_dir_(utils::path_from_utf8(root_dir)) {
+    std::error_code ec;
+    canonical_root_ = fs::weakly_canonical(root_dir_, ec);
+    if (ec) {
+        canonical_root_ = root_dir_.lexically_normal();
+    }
+    if (!canonical_root_.has_filename()) {
+        canonical_root_ = canonical_root_.parent_path();  // Drop a trailing separator
+    }
+}
+
+void StaticAssetCache::set_transform(const std::string& relative_path, Transform transform) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    transforms_[relative_path] = std::move(transform);
+    auto it = assets_.find(relative_path);
+    if (it != assets_.end()) {
+        cached_bytes_ -= it->second->bytes;
+        assets_.erase(it);
+    }
+}
+
+void StaticAssetCache::warm(const std::string& relative_path) {
+    if (!load(relative_path)) {
+        LOG(WARNING, "Server") << "Could not preload web app file: " << relative_path << std::endl;
+    }
+}
+
+std::string StaticAssetCache::content_type_for(const std::string& path) {
+    size_t dot_pos = path.rfind('.');
+    if (dot_pos == std::string::npos) {
+        return "application/octet-stream";
+    }
+    std::string ext = path.substr(dot_pos);
+    if (ext == ".js") return "text/javascript";
+    if (ext == ".css") return "text/css";
+    if (ext == ".html") return "text/html";
+    if (ext == ".woff") return "font/woff";
+    if (ext == ".woff2") return "font/woff2";
+    if (ext == ".ttf") return "font/ttf";
+    if (ext == ".svg") return "image/svg+xml";
+    if (ext == ".png") return "image/png";
+    if (ext == ".jpg" || ext == ".jpeg") return "image/jpeg";
+    if (ext == ".json") return "application/json";
+    if (ext == ".ico") return "image/x-icon";
+    return "application/octet-stream";
+}
+
+bool StaticAssetCache::resolve(const std::string& relative_path, fs::path& full_path, std::string& key) const {
+    // Only plain relative paths: "/etc/passwd" or "C:/x" would replace root_dir_ when joined
+    fs::path rel = utils::path_from_utf8(relative_path);
+    if (rel.empty() || rel.is_absolute() || rel.has_root_name() || rel.has_root_directory()) {
+        return false;
+    }
+    for (const auto& part : rel) {
+        if (part == "..") {
+            return false;
+        }
+    }
+
+    // Symlinks may still point elsewhere, so the resolved file must stay under the root
+    std::error_code ec;
+    fs::path resolved = fs::weakly_canonical(root_dir_ / rel, ec);
+    if (ec) {
+        return false;
+    }
+    auto mismatch = std::mismatch(canonical_root_.begin(), canonical_root_.end(),
+                                  resolved.begin(), resolved.end());
+    if (mismatch.first != canonical_root_.end()) {
+        return false;
+    }
+
+    full_path = root_dir_ / rel;
+    key = rel.lexically_normal().generic_string();  // "a//b.js" and "a/./b.js" share an entry
+    return true;
+}
+
+std::shared_ptr<const StaticAssetCache::Asset> StaticAssetCache::load(const std::string& relative_path) {
+    fs::path full_path;
+    std::string key;
+    if (!resolve(relative_path, full_path, key)) {
+        return nullptr;
+    }
+
+    std::error_code ec;
+    auto mtime = fs::last_write_time(full_path, ec);
+    if (ec || !fs::is_regular_file(full_path, ec)) {
+        return nullptr;
+    }
+
+    Transform transform;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = assets_.find(key);
+        if (it != assets_.end() && it->second->mtime == mtime) {
+            return it->second;
+        }
+        auto t = transforms_.find(key);
+        if (t != transforms_.end()) {
+            transform = t->second;
+        }
+    }
+
+    std::ifstream file(full_path, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    if (transform) {
+        content = transform(std::move(content));
+    }
+
+    auto asset = std::make_shared<Asset>();
+    asset->body.content_type = content_type_for(key);
+    asset->body.etag = hash_etag(content);
+    asset->mtime = mtime;
+    asset->immutable = std::regex_search(full_path.filename().string(), HASHED_NAME);
+
+    // Compress once here instead of on every response
+    if (content.size() >= MIN_COMPRESS_BYTES &&
+        http_compression::is_compressible(asset->body.content_type)) {
+        for (const auto& encoding : http_compression::available_encodings()) {
+            auto out = std::make_shared<std::string>();
+            if (http_compression::compress(encoding, content, *out) && out->size() < content.size()) {
+                asset->body.encoded[encoding] = out;
+            }
+        }
+    }
+    asset->body.identity = std::make_shared<const std::string>(std::move(content));
+
+    size_t asset_bytes = asset->body.identity->size();
+    for (const auto& variant : asset->body.encoded) {
+        asset_bytes += variant.second->size();
+    }
+    asset->bytes = asset_bytes;
+
+    // Files too large for the budget are served without being kept
+    if (asset_bytes > MAX_CACHED_BYTES) {
+        return asset;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto previous = assets_.find(key);
+    if (previous != assets_.end()) {
+        cached_bytes_ -= previous->second->bytes;
+        assets_.erase(previous);
+    }
+    while (cached_bytes_ + asset_bytes > MAX_CACHED_BYTES && !assets_.empty()) {
+        cached_bytes_ -= assets_.begin()->second->bytes;
+        assets_.erase(assets_.begin());
+    }
+    assets_[key] = asset;
+    cached_bytes_ += asset_bytes;
+    return asset;
+}
+
+void StaticAssetCache::serve(const httplib::Request& req, httplib::Response& res,
+                             const std::string& relative_path) {
+    auto asset = load(relative_path);
+    if (!asset) {
+        res.status = 404;
+        res.set_content("File not found", "text/plain");
+        return;
+    }
+
+    http_compression::send_representation(
+        req, res, asset->body,
+        asset->immutable ? "public, max-age=31536000, immutable" : "no-cache",
+        !asset->body.encoded.empty());
+}
+
+} // namespace lemon
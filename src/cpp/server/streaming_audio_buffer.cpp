@@ -1,32 +1,77 @@
 #include "lemon/streaming_audio_buffer.h"
-#include <ixwebsocket/IXBase64.h>
+#include <array>
 #include <cstring>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <lemon/utils/aixlog.hpp>
 
 namespace lemon {
 
+// Decode base64 into out, which must hold at least 3 * (in.size() / 4) + 3 bytes.
+// Whitespace and other non-alphabet characters are skipped; decoding stops at padding.
+// Returns the number of bytes written.
+static size_t decode_base64(const std::string& in, uint8_t* out) {
+    static const std::array<int8_t, 256> table = [] {
+        std::array<int8_t, 256> t;
+        t.fill(-1);
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; i++) {
+            t[static_cast<unsigned char>(alphabet[i])] = static_cast<int8_t>(i);
+        }
+        return t;
+    }();
+
+    uint32_t acc = 0;
+    int bits = 0;
+    size_t n = 0;
+    for (unsigned char c : in) {
+        int8_t v = table[c];
+        if (v < 0) {
+            if (c == '=') break;
+            continue;
+        }
+        acc = (acc << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out[n++] = static_cast<uint8_t>((acc >> bits) & 0xFF);
+        }
+    }
+    return n;
+}
+
+StreamingAudioBuffer::StreamingAudioBuffer()
+    : tail_(TAIL_SAMPLES, 0.0f) {
+    samples_.reserve(RESERVED_SAMPLES);
+}
+
 void StreamingAudioBuffer::append(const std::string& base64_audio) {
     if (base64_audio.empty()) {
         return;
     }
 
-    // Decode base64 to raw bytes using ixwebsocket's base64 implementation
-    std::string decoded_str;
-    macaron::Base64::Decode(base64_audio, decoded_str);
-    const auto* raw_bytes = reinterpret_cast<const uint8_t*>(decoded_str.data());
-    size_t raw_size = decoded_str.size();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Decode straight into the sample storage: grow it by the largest possible decoded
+    // size, decode the bytes in place, then trim to what was actually decoded
+    size_t old_size = samples_.size();
+    size_t max_bytes = base64_audio.size() / 4 * 3 + 3;
+    samples_.resize(old_size + max_bytes / 2 + 1);
 
-    // Convert bytes to int16 samples (little-endian)
+    auto* raw_bytes = reinterpret_cast<uint8_t*>(samples_.data() + old_size);
+    size_t raw_size = decode_base64(base64_audio, raw_bytes);
     size_t num_samples = raw_size / 2;
-    std::vector<int16_t> new_samples(num_samples);
 
+    // PCM16 arrives little-endian; each sample is rebuilt from its own two bytes, so this
+    // is safe in place (and a no-op on little-endian hosts)
+    int16_t* new_samples = samples_.data() + old_size;
     for (size_t i = 0; i < num_samples; i++) {
         new_samples[i] = static_cast<int16_t>(
             raw_bytes[i * 2] | (raw_bytes[i * 2 + 1] << 8)
         );
     }
+    samples_.resize(old_size + num_samples);
 
     // Diagnostic: log first chunk's data to verify decode pipeline
     static bool logged_first = false;
@@ -35,11 +80,6 @@ void StreamingAudioBuffer::append(const std::string& base64_audio) {
         LOG(DEBUG, "AudioBuffer") << "base64 length=" << base64_audio.size()
                   << " decoded bytes=" << raw_size
                   << " samples=" << num_samples << std::endl;
-        LOG(DEBUG, "AudioBuffer") << "first 8 raw bytes:";
-        for (size_t i = 0; i < (std::min)(raw_size, size_t(8)); i++) {
-            LOG(DEBUG, "AudioBuffer") << " " << static_cast<int>(raw_bytes[i]);
-        }
-        LOG(DEBUG, "AudioBuffer") << std::endl;
         LOG(DEBUG, "AudioBuffer") << "first 4 int16 samples:";
         for (size_t i = 0; i < (std::min)(num_samples, size_t(4)); i++) {
             LOG(DEBUG, "AudioBuffer") << " " << new_samples[i];
@@ -48,8 +88,7 @@ void StreamingAudioBuffer::append(const std::string& base64_audio) {
         LOG(DEBUG, "AudioBuffer") << "base64 prefix: " << base64_audio.substr(0, 40) << std::endl;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    samples_.insert(samples_.end(), new_samples.begin(), new_samples.end());
+    finish_append(old_size);
 }
 
 void StreamingAudioBuffer::append_raw(const std::vector<int16_t>& samples) {
@@ -58,12 +97,104 @@ void StreamingAudioBuffer::append_raw(const std::vector<int16_t>& samples) {
     }
 
     std::lock_guard<std::mutex> lock(mutex_);
+    size_t old_size = samples_.size();
     samples_.insert(samples_.end(), samples.begin(), samples.end());
+    finish_append(old_size);
+}
+
+void StreamingAudioBuffer::append_raw(const uint8_t* data, size_t size) {
+    size_t num_samples = size / 2;
+    if (num_samples == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t old_size = samples_.size();
+    samples_.resize(old_size + num_samples);
+    int16_t* new_samples = samples_.data() + old_size;
+    for (size_t i = 0; i < num_samples; i++) {
+        new_samples[i] = static_cast<int16_t>(data[i * 2] | (data[i * 2 + 1] << 8));
+    }
+
+    finish_append(old_size);
+}
+
+void StreamingAudioBuffer::set_input_sample_rate(int sample_rate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sample_rate == SAMPLE_RATE) {
+        resampler_.reset();
+    } else {
+        resampler_ = std::make_unique<utils::AudioResampler>(sample_rate, SAMPLE_RATE);
+    }
 }
 
-std::vector<uint8_t> StreamingAudioBuffer::build_wav(const std::vector<int16_t>& samples) {
+void StreamingAudioBuffer::finish_append(size_t old_size) {
+    if (resampler_) {
+        size_t count = samples_.size() - old_size;
+        resample_in_.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            resample_in_[i] = samples_[old_size + i] / 32768.0f;
+        }
+
+        resample_out_.clear();
+        resampler_->process(resample_in_.data(), count, resample_out_);
+
+        samples_.resize(old_size + resample_out_.size());
+        for (size_t i = 0; i < resample_out_.size(); i++) {
+            samples_[old_size + i] = utils::AudioUtils::to_pcm16(resample_out_[i]);
+        }
+    }
+
+    update_tail(samples_.data() + old_size, samples_.size() - old_size);
+}
+
+void StreamingAudioBuffer::update_tail(const int16_t* samples, size_t count) {
+    if (count > TAIL_SAMPLES) {
+        samples += count - TAIL_SAMPLES;
+        count = TAIL_SAMPLES;
+    }
+
+    while (count > 0) {
+        size_t run = (std::min)(count, TAIL_SAMPLES - tail_pos_);
+        float* dst = tail_.data() + tail_pos_;
+        for (size_t i = 0; i < run; i++) {
+            dst[i] = samples[i] / 32768.0f;
+        }
+        samples += run;
+        count -= run;
+        tail_pos_ = (tail_pos_ + run) % TAIL_SAMPLES;
+    }
+}
+
+void StreamingAudioBuffer::copy_samples(size_t start, size_t end, std::vector<float>& out) const {
+    out.resize(end - start);
+    if (out.empty()) {
+        return;
+    }
+
+    size_t total = samples_.size();
+    size_t tail_count = (std::min)(total, TAIL_SAMPLES);
+
+    if (start < total - tail_count) {
+        // Older than the cached tail: convert from int16
+        for (size_t i = 0; i < out.size(); i++) {
+            out[i] = samples_[start + i] / 32768.0f;
+        }
+        return;
+    }
+
+    // Sample k lives at ring index (tail_pos_ - (total - k)) mod TAIL_SAMPLES
+    size_t index = (tail_pos_ + TAIL_SAMPLES - (total - start)) % TAIL_SAMPLES;
+    size_t first = (std::min)(out.size(), TAIL_SAMPLES - index);
+    std::memcpy(out.data(), tail_.data() + index, first * sizeof(float));
+    std::memcpy(out.data() + first, tail_.data(), (out.size() - first) * sizeof(float));
+}
+
+std::string StreamingAudioBuffer::build_wav(const int16_t* samples, size_t count, size_t min_samples) {
     // WAV file header constants
-    const uint32_t data_size = static_cast<uint32_t>(samples.size() * sizeof(int16_t));
+    const size_t padded_count = (std::max)(count, min_samples);
+    const uint32_t data_size = static_cast<uint32_t>(padded_count * sizeof(int16_t));
     const uint32_t file_size = 36 + data_size;
     const uint16_t audio_format = 1;  // PCM
     const uint16_t num_channels = CHANNELS;
@@ -72,28 +203,33 @@ std::vector<uint8_t> StreamingAudioBuffer::build_wav(const std::vector<int16_t>&
     const uint16_t block_align = num_channels * (BITS_PER_SAMPLE / 8);
     const uint16_t bits_per_sample = BITS_PER_SAMPLE;
 
-    std::vector<uint8_t> wav;
-    wav.reserve(44 + data_size);
+    // One allocation for header + samples; the zero-initialized remainder is the silence padding
+    std::string wav(44 + data_size, '\0');
+    uint8_t* p = reinterpret_cast<uint8_t*>(&wav[0]);
 
-    // Helper to write little-endian values
-    auto write_u16 = [&wav](uint16_t val) {
-        wav.push_back(val & 0xFF);
-        wav.push_back((val >> 8) & 0xFF);
+    // Helpers to write tags and little-endian values
+    auto write_tag = [&p](const char* tag) {
+        std::memcpy(p, tag, 4);
+        p += 4;
+    };
+    auto write_u16 = [&p](uint16_t val) {
+        *p++ = val & 0xFF;
+        *p++ = (val >> 8) & 0xFF;
     };
-    auto write_u32 = [&wav](uint32_t val) {
-        wav.push_back(val & 0xFF);
-        wav.push_back((val >> 8) & 0xFF);
-        wav.push_back((val >> 16) & 0xFF);
-        wav.push_back((val >> 24) & 0xFF);
+    auto write_u32 = [&p](uint32_t val) {
+        *p++ = val & 0xFF;
+        *p++ = (val >> 8) & 0xFF;
+        *p++ = (val >> 16) & 0xFF;
+        *p++ = (val >> 24) & 0xFF;
     };
 
     // RIFF header
-    wav.push_back('R'); wav.push_back('I'); wav.push_back('F'); wav.push_back('F');
+    write_tag("RIFF");
     write_u32(file_size);
-    wav.push_back('W'); wav.push_back('A'); wav.push_back('V'); wav.push_back('E');
+    write_tag("WAVE");
 
     // fmt chunk
-    wav.push_back('f'); wav.push_back('m'); wav.push_back('t'); wav.push_back(' ');
+    write_tag("fmt ");
     write_u32(16);  // Subchunk1Size for PCM
     write_u16(audio_format);
     write_u16(num_channels);
@@ -103,49 +239,60 @@ std::vector<uint8_t> StreamingAudioBuffer::build_wav(const std::vector<int16_t>&
     write_u16(bits_per_sample);
 
     // data chunk
-    wav.push_back('d'); wav.push_back('a'); wav.push_back('t'); wav.push_back('a');
+    write_tag("data");
     write_u32(data_size);
 
     // Audio data (already in little-endian int16 format)
-    const uint8_t* sample_bytes = reinterpret_cast<const uint8_t*>(samples.data());
-    wav.insert(wav.end(), sample_bytes, sample_bytes + data_size);
+    if (count > 0) {
+        std::memcpy(p, samples, count * sizeof(int16_t));
+    }
 
     return wav;
 }
 
-std::vector<uint8_t> StreamingAudioBuffer::get_wav() const {
+std::string StreamingAudioBuffer::get_wav() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return build_wav(samples_);
+    return build_wav(samples_.data(), samples_.size());
 }
 
-std::vector<uint8_t> StreamingAudioBuffer::get_wav_padded(int min_duration_ms) const {
+std::string StreamingAudioBuffer::get_wav_padded(int min_duration_ms) const {
+    return get_wav_from(0, min_duration_ms);
+}
+
+std::string StreamingAudioBuffer::get_wav_from(size_t start_sample, int min_duration_ms) const {
     std::lock_guard<std::mutex> lock(mutex_);
 
     size_t min_samples = static_cast<size_t>(min_duration_ms) * SAMPLE_RATE / 1000;
+    start_sample = (std::min)(start_sample, samples_.size());
 
-    if (samples_.size() >= min_samples) {
-        // No padding needed
-        return build_wav(samples_);
-    }
+    // Export the requested range, padded with silence (zeros) at the end
+    return build_wav(samples_.data() + start_sample, samples_.size() - start_sample, min_samples);
+}
 
-    // Copy samples and pad with silence (zeros) at the end
-    std::vector<int16_t> padded_samples(samples_);
-    padded_samples.resize(min_samples, 0);
+std::vector<float> StreamingAudioBuffer::get_samples() const {
+    return get_samples_from(0);
+}
 
-    return build_wav(padded_samples);
+std::vector<float> StreamingAudioBuffer::get_samples_from(size_t start_sample) const {
+    std::vector<float> float_samples;
+    get_samples_from(start_sample, float_samples);
+    return float_samples;
 }
 
-std::vector<float> StreamingAudioBuffer::get_samples() const {
+void StreamingAudioBuffer::get_samples_from(size_t start_sample, std::vector<float>& out) const {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    std::vector<float> float_samples(samples_.size());
-    for (size_t i = 0; i < samples_.size(); i++) {
-        float_samples[i] = samples_[i] / 32768.0f;
-    }
-    return float_samples;
+    start_sample = (std::min)(start_sample, samples_.size());
+    copy_samples(start_sample, samples_.size(), out);
 }
 
 std::vector<float> StreamingAudioBuffer::get_recent_samples(int ms) const {
+    std::vector<float> float_samples;
+    get_recent_samples(ms, float_samples);
+    return float_samples;
+}
+
+void StreamingAudioBuffer::get_recent_samples(int ms, std::vector<float>& out) const {
     std::lock_guard<std::mutex> lock(mutex_);
 
     size_t num_samples = static_cast<size_t>(ms * SAMPLE_RATE / 1000);
@@ -153,18 +300,16 @@ std::vector<float> StreamingAudioBuffer::get_recent_samples(int ms) const {
         num_samples = samples_.size();
     }
 
-    std::vector<float> float_samples(num_samples);
-    size_t start_idx = samples_.size() - num_samples;
-
-    for (size_t i = 0; i < num_samples; i++) {
-        float_samples[i] = samples_[start_idx + i] / 32768.0f;
-    }
-    return float_samples;
+    copy_samples(samples_.size() - num_samples, samples_.size(), out);
 }
 
 void StreamingAudioBuffer::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
-    samples_.clear();
+    samples_.clear();  // Keeps the reserved capacity for the next utterance
+    tail_pos_ = 0;
+    if (resampler_) {
+        resampler_->reset();
+    }
 }
 
 int StreamingAudioBuffer::duration_ms() const {
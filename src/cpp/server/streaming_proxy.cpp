@@ -1,10 +1,67 @@
 #include "lemon/streaming_proxy.h"
+#include "lemon/tracing.h"
+#include <chrono>
 #include <sstream>
 #include <iostream>
 #include <lemon/utils/aixlog.hpp>
 
 namespace lemon {
 
+// Bytes of the most recent SSE lines kept for telemetry parsing
+static const size_t TELEMETRY_TAIL_BYTES = 64 * 1024;
+
+// A writability probe that fails faster than this found the connection closed, not full
+static const auto CLOSED_PROBE_TIME = std::chrono::milliseconds(500);
+
+std::atomic<int> StreamingProxy::stall_timeout_seconds_{120};
+std::atomic<int> StreamingProxy::stalled_clients_{0};
+std::atomic<uint64_t> StreamingProxy::stalled_clients_dropped_{0};
+
+json StreamingProxy::get_stats() {
+    return {
+        {"active", utils::HttpClient::get_active_streams()},
+        {"stalled", stalled_clients_.load()},
+        {"stalled_clients_dropped", stalled_clients_dropped_.load()},
+        {"stall_timeout", stall_timeout_seconds_.load()}
+    };
+}
+
+bool StreamingProxy::write_to_client(httplib::DataSink& sink, const char* data, size_t length) {
+    // Chunks are written from the backend transfer's callback, so while the client is not
+    // reading the backend is not read either and nothing piles up here. is_writable() waits
+    // up to the listener's write timeout for socket buffer space; waiting for the stall
+    // timeout here, instead of raising that timeout, leaves every other response with
+    // httplib's short write timeout.
+    auto start = std::chrono::steady_clock::now();
+    auto probe_start = start;
+    bool stalled = false;
+    bool writable = true;
+    while (!sink.is_writable()) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - probe_start < CLOSED_PROBE_TIME) {
+            writable = false;  // Client disconnected
+            break;
+        }
+        if (!stalled) {
+            stalled = true;
+            stalled_clients_++;
+        }
+        int stall_timeout = stall_timeout_seconds_.load();
+        if (stall_timeout > 0 && now - start >= std::chrono::seconds(stall_timeout)) {
+            stalled_clients_dropped_++;
+            LOG(WARNING, "StreamingProxy") << "Client has not read for " << stall_timeout
+                                           << "s, dropping stream" << std::endl;
+            writable = false;
+            break;
+        }
+        probe_start = now;
+    }
+    if (stalled) {
+        stalled_clients_--;
+    }
+    return writable && sink.write(data, length);
+}
+
 void StreamingProxy::forward_sse_stream(
     const std::string& backend_url,
     const std::string& request_body,
@@ -14,25 +71,30 @@ void StreamingProxy::forward_sse_stream(
 
     std::string telemetry_buffer;
     bool stream_error = false;
-    bool has_done_marker = false;
+
+    tracing::Span stream_span("backend_stream", backend_url);
+    tracing::Span first_token_span("first_token", backend_url);
 
     // Use HttpClient to stream from backend
     auto result = utils::HttpClient::post_stream(
         backend_url,
         request_body,
-        [&sink, &telemetry_buffer, &has_done_marker](const char* data, size_t length) {
-            // Buffer for telemetry parsing
-            telemetry_buffer.append(data, length);
+        [&sink, &telemetry_buffer, &first_token_span](const char* data, size_t length) {
+            first_token_span.finish();
 
-            // Check if this chunk contains [DONE]
-            std::string chunk(data, length);
-            if (chunk.find("[DONE]") != std::string::npos) {
-                has_done_marker = true;
+            // Keep only the tail of the stream for telemetry parsing: usage/timings arrive
+            // in the final events, so the buffer stays bounded however long the stream runs
+            telemetry_buffer.append(data, length);
+            if (telemetry_buffer.size() > 2 * TELEMETRY_TAIL_BYTES) {
+                size_t cut = telemetry_buffer.find('\n', telemetry_buffer.size() - TELEMETRY_TAIL_BYTES);
+                if (cut != std::string::npos) {
+                    telemetry_buffer.erase(0, cut + 1);
+                }
             }
 
             // Forward chunk to client immediately
-            if (!sink.write(data, length)) {
-                return false; // Client disconnected
+            if (!write_to_client(sink, data, length)) {
+                return false; // Client disconnected or stalled
             }
 
             return true; // Continue streaming
@@ -41,6 +103,9 @@ void StreamingProxy::forward_sse_stream(
         timeout_seconds
     );
 
+    // Check the tail rather than individual chunks so a marker split across chunks is found
+    bool has_done_marker = telemetry_buffer.find("[DONE]") != std::string::npos;
+
     if (result.status_code != 200) {
         stream_error = true;
         LOG(ERROR, "StreamingProxy") << "Backend returned error: " << result.status_code << std::endl;
@@ -72,22 +137,29 @@ void StreamingProxy::forward_sse_stream(
     }
 }
 
-void StreamingProxy::forward_byte_stream(
+bool StreamingProxy::forward_byte_stream(
     const std::string& backend_url,
     const std::string& request_body,
     httplib::DataSink& sink,
     long timeout_seconds) {
 
     bool stream_error = false;
+    bool client_gone = false;
+
+    tracing::Span stream_span("backend_stream", backend_url);
+    tracing::Span first_byte_span("first_byte", backend_url);
 
     // Use HttpClient to stream from backend
     auto result = utils::HttpClient::post_stream(
         backend_url,
         request_body,
-        [&sink](const char* data, size_t length) {
+        [&sink, &first_byte_span, &client_gone](const char* data, size_t length) {
+            first_byte_span.finish();
+
             // Forward chunk to client immediately
-            if (!sink.write(data, length)) {
-                return false; // Client disconnected
+            if (!write_to_client(sink, data, length)) {
+                client_gone = true;
+                return false; // Client disconnected or stalled
             }
 
             return true; // Continue streaming
@@ -109,6 +181,7 @@ void StreamingProxy::forward_byte_stream(
         // Properly terminate the chunked response even on error
         sink.done();
     }
+    return !stream_error && !client_gone;
 }
 
 StreamingProxy::TelemetryData StreamingProxy::parse_telemetry(const std::string& buffer) {
@@ -179,6 +252,13 @@ StreamingProxy::TelemetryData StreamingProxy::parse_telemetry(const std::string&
                 if (timings.contains("predicted_per_second")) {
                     telemetry.tokens_per_second = timings["predicted_per_second"].get<double>();
                 }
+                // Present when llama-server runs with a draft model
+                if (timings.contains("draft_n")) {
+                    telemetry.draft_tokens = timings["draft_n"].get<int>();
+                }
+                if (timings.contains("draft_n_accepted")) {
+                    telemetry.draft_tokens_accepted = timings["draft_n_accepted"].get<int>();
+                }
             }
         } catch (const std::exception& e) {
             LOG(ERROR, "StreamingProxy") << "Error parsing telemetry: " << e.what() << std::endl;
@@ -0,0 +1,206 @@
+#include "lemon/tracing.h"
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace lemon {
+namespace tracing {
+
+namespace {
+
+constexpr size_t RING_CAPACITY = 8192;  // Must be a power of two
+constexpr size_t NAME_BYTES = 32;
+constexpr size_t DETAIL_BYTES = 96;
+
+struct SpanRecord {
+    uint64_t request_id;
+    int64_t start_us;     // Wall clock, microseconds since the epoch
+    int64_t duration_us;
+    uint64_t thread_hash;
+    char name[NAME_BYTES];
+    char detail[DETAIL_BYTES];
+};
+
+// Each slot is guarded by a sequence number: odd while being written, even when stable.
+// Writers claim slots with a fetch_add and never block; readers skip slots that change
+// underneath them.
+struct Slot {
+    std::atomic<uint64_t> seq{0};
+    SpanRecord record;
+};
+
+std::array<Slot, RING_CAPACITY> ring;
+std::atomic<uint64_t> next_slot{0};
+std::atomic<uint64_t> next_request_id{1};
+
+thread_local uint64_t current_request_id = 0;
+thread_local std::chrono::system_clock::time_point request_wall_start;
+thread_local std::chrono::steady_clock::time_point request_start;
+
+void copy_truncated(char* dst, size_t capacity, const char* src, size_t length) {
+    size_t n = std::min(length, capacity - 1);
+    std::memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+std::vector<SpanRecord> snapshot(uint64_t request_id) {
+    std::vector<SpanRecord> out;
+    uint64_t end = next_slot.load(std::memory_order_acquire);
+    uint64_t begin = end > RING_CAPACITY ? end - RING_CAPACITY : 0;
+    out.reserve(static_cast<size_t>(end - begin));
+
+    for (uint64_t i = begin; i < end; i++) {
+        Slot& slot = ring[i & (RING_CAPACITY - 1)];
+        uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;  // Being written
+        }
+        SpanRecord copy;
+        std::memcpy(&copy, &slot.record, sizeof(copy));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != before) {
+            continue;  // Overwritten while copying
+        }
+        if (request_id == 0 || copy.request_id == request_id) {
+            out.push_back(copy);
+        }
+    }
+    return out;
+}
+
+std::string hex_id(uint64_t value, int width) {
+    std::ostringstream oss;
+    oss << std::hex << std::setw(width) << std::setfill('0') << value;
+    return oss.str();
+}
+
+} // namespace
+
+uint64_t begin_request() {
+    current_request_id = next_request_id.fetch_add(1, std::memory_order_relaxed);
+    request_wall_start = std::chrono::system_clock::now();
+    request_start = std::chrono::steady_clock::now();
+    return current_request_id;
+}
+
+void end_request(const std::string& detail) {
+    if (current_request_id == 0) {
+        return;
+    }
+    record("request", request_wall_start, std::chrono::steady_clock::now() - request_start, detail);
+    current_request_id = 0;
+}
+
+uint64_t current_request() {
+    return current_request_id;
+}
+
+void set_current_request(uint64_t request_id) {
+    current_request_id = request_id;
+}
+
+void record(const char* name,
+            std::chrono::system_clock::time_point start,
+            std::chrono::steady_clock::duration duration,
+            const std::string& detail) {
+    if (current_request_id == 0) {
+        return;
+    }
+
+    uint64_t index = next_slot.fetch_add(1, std::memory_order_acq_rel);
+    Slot& slot = ring[index & (RING_CAPACITY - 1)];
+
+    uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq | 1, std::memory_order_release);  // Mark as being written
+    std::atomic_thread_fence(std::memory_order_release);
+
+    SpanRecord& rec = slot.record;
+    rec.request_id = current_request_id;
+    rec.start_us = std::chrono::duration_cast<std::chrono::microseconds>(start.time_since_epoch()).count();
+    rec.duration_us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    rec.thread_hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+    copy_truncated(rec.name, NAME_BYTES, name, std::strlen(name));
+    copy_truncated(rec.detail, DETAIL_BYTES, detail.data(), detail.size());
+
+    slot.seq.store((seq | 1) + 1, std::memory_order_release);
+}
+
+Span::Span(const char* name, std::string detail)
+    : name_(name), detail_(std::move(detail)),
+      wall_start_(std::chrono::system_clock::now()),
+      start_(std::chrono::steady_clock::now()) {}
+
+Span::~Span() {
+    finish();
+}
+
+void Span::finish() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+    record(name_, wall_start_, std::chrono::steady_clock::now() - start_, detail_);
+}
+
+json export_chrome_trace(uint64_t request_id) {
+    json events = json::array();
+    for (const auto& rec : snapshot(request_id)) {
+        json event = {
+            {"name", rec.name},
+            {"cat", "lemonade"},
+            {"ph", "X"},
+            {"ts", rec.start_us},
+            {"dur", rec.duration_us},
+            {"pid", 1},
+            {"tid", rec.request_id},  // One lane per request
+            {"args", {{"request_id", rec.request_id}}}
+        };
+        if (rec.detail[0] != '\0') {
+            event["args"]["detail"] = rec.detail;
+        }
+        events.push_back(std::move(event));
+    }
+    return {{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+}
+
+json export_otlp(uint64_t request_id) {
+    json spans = json::array();
+    for (const auto& rec : snapshot(request_id)) {
+        // Requests map to traces; span ids only need to be unique within this export
+        uint64_t span_id = (rec.request_id << 32) ^ static_cast<uint64_t>(rec.start_us) ^ rec.thread_hash;
+        json attributes = json::array({
+            {{"key", "lemonade.request_id"}, {"value", {{"intValue", std::to_string(rec.request_id)}}}}
+        });
+        if (rec.detail[0] != '\0') {
+            attributes.push_back({{"key", "lemonade.detail"}, {"value", {{"stringValue", rec.detail}}}});
+        }
+        spans.push_back({
+            {"traceId", hex_id(rec.request_id, 32)},
+            {"spanId", hex_id(span_id, 16)},
+            {"name", rec.name},
+            {"kind", 1},
+            {"startTimeUnixNano", std::to_string(rec.start_us * 1000)},
+            {"endTimeUnixNano", std::to_string((rec.start_us + rec.duration_us) * 1000)},
+            {"attributes", attributes}
+        });
+    }
+
+    return {
+        {"resourceSpans", json::array({{
+            {"resource", {{"attributes", json::array({
+                {{"key", "service.name"}, {"value", {{"stringValue", "lemonade-server"}}}}
+            })}}},
+            {"scopeSpans", json::array({{
+                {"scope", {{"name", "lemonade"}}},
+                {"spans", spans}
+            }})}
+        }})}
+    };
+}
+
+} // namespace tracing
+} // namespace lemon
@@ -0,0 +1,146 @@
+#include "lemon/transcript_stitcher.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace lemon {
+
+static void split_words(const std::string& text, double segment_end_s,
+                        std::vector<TranscriptStitcher::Word>& out) {
+    std::istringstream stream(text);
+    std::string token;
+    size_t first = out.size();
+    while (stream >> token) {
+        out.push_back({token, -1.0});
+    }
+    if (out.size() > first && segment_end_s >= 0.0) {
+        out.back().end_s = segment_end_s;
+    }
+}
+
+std::vector<TranscriptStitcher::Word> TranscriptStitcher::words_from_response(const json& response) {
+    std::vector<Word> words;
+
+    if (response.contains("segments") && response["segments"].is_array()) {
+        for (const auto& segment : response["segments"]) {
+            if (!segment.contains("text") || !segment["text"].is_string()) {
+                continue;
+            }
+            double end_s = segment.contains("end") && segment["end"].is_number()
+                ? segment["end"].get<double>() : -1.0;
+            split_words(segment["text"].get<std::string>(), end_s, words);
+        }
+        return words;
+    }
+
+    if (response.contains("text") && response["text"].is_string()) {
+        split_words(response["text"].get<std::string>(), -1.0, words);
+    }
+    return words;
+}
+
+std::string TranscriptStitcher::normalize(const std::string& word) {
+    // Case and punctuation differ between passes ("Hello," vs "hello"); compare the letters
+    std::string out;
+    out.reserve(word.size());
+    for (unsigned char c : word) {
+        if (c >= 0x80 || std::isalnum(c)) {
+            out += static_cast<char>(std::tolower(c));
+        }
+    }
+    return out;
+}
+
+size_t TranscriptStitcher::update(const std::vector<Word>& hypothesis) {
+    // The hypothesis covers the whole window; what follows the committed words is new
+    size_t offset = std::min(window_committed_.size(), hypothesis.size());
+    std::vector<Word> tail(hypothesis.begin() + offset, hypothesis.end());
+
+    // LocalAgreement-2: commit the longest prefix this pass shares with the previous one
+    size_t agreed = 0;
+    while (agreed < tail.size() && agreed < tentative_.size() &&
+           normalize(tail[agreed].text) == normalize(tentative_[agreed].text)) {
+        agreed++;
+    }
+
+    window_committed_.insert(window_committed_.end(), tail.begin(), tail.begin() + agreed);
+    tentative_.assign(tail.begin() + agreed, tail.end());
+    return agreed;
+}
+
+double TranscriptStitcher::committed_end_s() const {
+    for (auto it = window_committed_.rbegin(); it != window_committed_.rend(); ++it) {
+        if (it->end_s >= 0.0) {
+            return it->end_s;
+        }
+    }
+    return -1.0;
+}
+
+void TranscriptStitcher::advance_window() {
+    // Words after the last timestamped one belong to audio that stays in the window,
+    // so Whisper will hear them again; keep them as tentative rather than duplicating them
+    size_t keep_from = window_committed_.size();
+    for (size_t i = window_committed_.size(); i > 0; i--) {
+        if (window_committed_[i - 1].end_s >= 0.0) {
+            keep_from = i;
+            break;
+        }
+    }
+
+    std::vector<Word> frozen(window_committed_.begin(), window_committed_.begin() + keep_from);
+    append_words(frozen_text_, frozen);
+
+    std::vector<Word> still_heard(window_committed_.begin() + keep_from, window_committed_.end());
+    still_heard.insert(still_heard.end(), tentative_.begin(), tentative_.end());
+    for (auto& word : still_heard) {
+        word.end_s = -1.0;  // Timestamps were relative to the old window start
+    }
+
+    window_committed_.clear();
+    tentative_ = std::move(still_heard);
+}
+
+void TranscriptStitcher::flush_window() {
+    append_words(frozen_text_, window_committed_);
+    append_words(frozen_text_, tentative_);
+    window_committed_.clear();
+    tentative_.clear();
+}
+
+std::string TranscriptStitcher::text() const {
+    std::string out = frozen_text_;
+    append_words(out, window_committed_);
+    append_words(out, tentative_);
+    return out;
+}
+
+std::string TranscriptStitcher::prompt(size_t max_chars) const {
+    // Words committed inside the window are spoken in the audio Whisper is about to hear;
+    // prompting with them as well makes it repeat them
+    if (frozen_text_.size() <= max_chars) {
+        return frozen_text_;
+    }
+
+    // Cut on a word boundary
+    size_t cut = frozen_text_.find(' ', frozen_text_.size() - max_chars);
+    return cut == std::string::npos ? frozen_text_.substr(frozen_text_.size() - max_chars)
+                                    : frozen_text_.substr(cut + 1);
+}
+
+void TranscriptStitcher::reset() {
+    frozen_text_.clear();
+    window_committed_.clear();
+    tentative_.clear();
+}
+
+void TranscriptStitcher::append_words(std::string& out, const std::vector<Word>& words) {
+    for (const auto& word : words) {
+        if (!out.empty()) {
+            out += ' ';
+        }
+        out += word.text;
+    }
+}
+
+} // namespace lemon
@@ -0,0 +1,205 @@
+#include <lemon/transcription_executor.h>
+#include <lemon/utils/aixlog.hpp>
+#include <algorithm>
+#include <chrono>
+
+namespace lemon {
+
+TranscriptionExecutor::TranscriptionExecutor(size_t workers, CapacityFn capacity)
+    : capacity_(std::move(capacity)) {
+    workers = std::max<size_t>(1, workers);
+    for (size_t i = 0; i < workers; i++) {
+        workers_.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+TranscriptionExecutor::~TranscriptionExecutor() {
+    shutdown();
+}
+
+bool TranscriptionExecutor::submit(const std::string& session_id, const std::string& model, Kind kind,
+                                   std::function<void()> run, std::function<void()> dropped) {
+    refresh_capacity(model);
+
+    std::vector<Job> stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (shutdown_) {
+            return false;
+        }
+
+        // The utterance is over: its queued interim results would be thrown away
+        if (kind == Kind::Final) {
+            collect_interim(session_id, stale);
+        }
+
+        queue_.push_back({session_id, model, kind, std::move(run), std::move(dropped),
+                          std::chrono::steady_clock::now()});
+        peak_queued_ = std::max(peak_queued_, queue_.size());
+    }
+    cv_.notify_one();
+
+    for (auto& job : stale) {
+        if (job.dropped) job.dropped();
+    }
+    return true;
+}
+
+void TranscriptionExecutor::drop_interim(const std::string& session_id) {
+    std::vector<Job> stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        collect_interim(session_id, stale);
+    }
+
+    for (auto& job : stale) {
+        if (job.dropped) job.dropped();
+    }
+}
+
+void TranscriptionExecutor::refresh_capacity(const std::string& model) {
+    int capacity = std::max(1, capacity_ ? capacity_(model) : 1);
+    std::lock_guard<std::mutex> lock(mutex_);
+    model_capacity_[model] = capacity;
+}
+
+void TranscriptionExecutor::collect_interim(const std::string& session_id, std::vector<Job>& out) {
+    for (auto it = queue_.begin(); it != queue_.end();) {
+        if (it->kind == Kind::Interim && it->session_id == session_id) {
+            out.push_back(std::move(*it));
+            it = queue_.erase(it);
+            dropped_stale_++;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TranscriptionExecutor::shutdown() {
+    std::vector<std::thread> workers;
+    std::deque<Job> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+        workers.swap(workers_);
+        abandoned.swap(queue_);
+    }
+    cv_.notify_all();
+
+    for (auto& job : abandoned) {
+        if (job.dropped) job.dropped();
+    }
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+bool TranscriptionExecutor::take_next(Job& job) {
+    std::unordered_set<std::string> seen_sessions;
+    auto candidate = queue_.end();
+
+    for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+        // Only a session's oldest queued job may start, and only when none of its jobs is running
+        bool first_for_session = seen_sessions.insert(it->session_id).second;
+        if (!first_for_session || running_sessions_.count(it->session_id)) {
+            continue;
+        }
+
+        // Capacities are refreshed outside the lock (on submit and after each job)
+        auto cap = model_capacity_.find(it->model);
+        int model_capacity = cap != model_capacity_.end() ? cap->second : 1;
+        auto running = running_models_.find(it->model);
+        if (running != running_models_.end() && running->second >= model_capacity) {
+            continue;
+        }
+
+        if (it->kind == Kind::Final) {
+            candidate = it;
+            break;
+        }
+        if (candidate == queue_.end()) {
+            candidate = it;
+        }
+    }
+
+    if (candidate == queue_.end()) {
+        return false;
+    }
+
+    job = std::move(*candidate);
+    queue_.erase(candidate);
+    return true;
+}
+
+void TranscriptionExecutor::worker_loop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&]() { return shutdown_ || take_next(job); });
+            if (shutdown_ && !job.run) {
+                return;
+            }
+
+            running_sessions_.insert(job.session_id);
+            running_models_[job.model]++;
+            running_++;
+        }
+
+        uint64_t wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - job.enqueued).count();
+        wait_ms_total_ += wait_ms;
+        uint64_t prev_max = wait_ms_max_.load();
+        while (wait_ms > prev_max && !wait_ms_max_.compare_exchange_weak(prev_max, wait_ms)) {}
+
+        try {
+            job.run();
+        } catch (const std::exception& e) {
+            LOG(ERROR, "TranscriptionExecutor") << "Transcription job failed: " << e.what() << std::endl;
+        }
+
+        (job.kind == Kind::Final ? completed_final_ : completed_interim_)++;
+
+        // Replicas may have been loaded or unloaded while the job ran
+        refresh_capacity(job.model);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_sessions_.erase(job.session_id);
+            if (--running_models_[job.model] <= 0) {
+                running_models_.erase(job.model);
+            }
+            running_--;
+        }
+        // The finished job may unblock its session's next job or another job for its model
+        cv_.notify_all();
+    }
+}
+
+json TranscriptionExecutor::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t queued_interim = 0;
+    for (const auto& job : queue_) {
+        if (job.kind == Kind::Interim) queued_interim++;
+    }
+
+    uint64_t completed = completed_interim_.load() + completed_final_.load();
+    return {
+        {"workers", workers_.size()},
+        {"running", running_},
+        {"queued", queue_.size()},
+        {"queued_interim", queued_interim},
+        {"queued_final", queue_.size() - queued_interim},
+        {"peak_queued", peak_queued_},
+        {"completed_interim", completed_interim_.load()},
+        {"completed_final", completed_final_.load()},
+        {"dropped_stale", dropped_stale_.load()},
+        {"avg_wait_ms", completed > 0 ? (double) wait_ms_total_.load() / completed : 0.0},
+        {"max_wait_ms", wait_ms_max_.load()}
+    };
+}
+
+} // namespace lemon
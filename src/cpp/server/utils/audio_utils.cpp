@@ -0,0 +1,297 @@
+#include <lemon/utils/audio_utils.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace lemon {
+namespace utils {
+
+// Filter quality: zero crossings of the sinc on each side, and the Kaiser window shape
+static const double ZERO_CROSSINGS = 16.0;
+static const double KAISER_BETA = 8.0;
+// Passband edge as a fraction of the lower Nyquist frequency
+static const double ROLLOFF = 0.94;
+
+static double bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+// Eight independent partial sums: vectorizes without -ffast-math (which a single float
+// accumulator needs, since reordering the additions changes the result)
+static float dot(const float* x, const float* h, size_t n) {
+    float acc[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t k = 0; k < n; k += 8) {
+        for (size_t j = 0; j < 8; j++) {
+            acc[j] += x[k + j] * h[k + j];
+        }
+    }
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+}
+
+AudioResampler::AudioResampler(int input_rate, int output_rate)
+    : input_rate_(input_rate), output_rate_(output_rate) {
+    if (input_rate <= 0 || output_rate <= 0) {
+        throw std::invalid_argument("Sample rates must be positive");
+    }
+
+    int g = std::gcd(input_rate, output_rate);
+    up_ = static_cast<size_t>(output_rate / g);
+    down_ = static_cast<size_t>(input_rate / g);
+
+    // Cutoff relative to the input Nyquist frequency; the filter widens when downsampling
+    double cutoff = std::min(1.0, static_cast<double>(up_) / down_) * ROLLOFF;
+    double half_width = ZERO_CROSSINGS / cutoff;  // In input samples
+    taps_ = static_cast<size_t>(std::ceil(half_width)) * 2;
+    taps_ = (taps_ + 7) / 8 * 8;
+
+    // Phase p produces outputs at input time base + p/up_; tap k reads input
+    // base - taps_/2 + 1 + k
+    const double pi = 3.14159265358979323846;
+    double i0_beta = bessel_i0(KAISER_BETA);
+    filters_.assign(up_ * taps_, 0.0f);
+    for (size_t p = 0; p < up_; p++) {
+        double frac = static_cast<double>(p) / up_;
+        double sum = 0.0;
+        std::vector<double> h(taps_, 0.0);
+        for (size_t k = 0; k < taps_; k++) {
+            double d = static_cast<double>(k) - static_cast<double>(taps_ / 2) + 1.0 - frac;
+            if (std::abs(d) >= half_width) continue;
+            double x = cutoff * d;
+            double sinc = (x == 0.0) ? 1.0 : std::sin(pi * x) / (pi * x);
+            double r = d / half_width;
+            double window = bessel_i0(KAISER_BETA * std::sqrt(1.0 - r * r)) / i0_beta;
+            h[k] = cutoff * sinc * window;
+            sum += h[k];
+        }
+        // Unity gain at DC for every phase
+        for (size_t k = 0; k < taps_; k++) {
+            filters_[p * taps_ + k] = static_cast<float>(sum != 0.0 ? h[k] / sum : 0.0);
+        }
+    }
+
+    reset();
+}
+
+void AudioResampler::reset() {
+    pending_.assign(taps_ / 2, 0.0f);
+    position_ = static_cast<uint64_t>(taps_ / 2) * up_;
+    input_total_ = 0;
+    output_total_ = 0;
+}
+
+void AudioResampler::process(const float* input, size_t count, std::vector<float>& output) {
+    if (up_ == down_) {
+        output.insert(output.end(), input, input + count);
+        return;
+    }
+
+    pending_.insert(pending_.end(), input, input + count);
+    input_total_ += count;
+
+    const size_t half = taps_ / 2;
+    while (true) {
+        size_t base = static_cast<size_t>(position_ / up_);
+        if (base + half >= pending_.size()) {
+            break;
+        }
+        size_t phase = static_cast<size_t>(position_ % up_);
+        output.push_back(dot(pending_.data() + base + 1 - half, filters_.data() + phase * taps_, taps_));
+        output_total_++;
+        position_ += down_;
+    }
+
+    // Drop input that no future output can reach
+    size_t base = static_cast<size_t>(position_ / up_);
+    size_t consumed = base + 1 - half;
+    if (consumed > 0 && consumed <= pending_.size()) {
+        pending_.erase(pending_.begin(), pending_.begin() + consumed);
+        position_ -= static_cast<uint64_t>(consumed) * up_;
+    }
+}
+
+void AudioResampler::flush(std::vector<float>& output) {
+    if (up_ != down_) {
+        // Push the held-back tail through with silence, stopping at ceil(input * up / down)
+        // samples in total
+        uint64_t expected = (input_total_ * up_ + down_ - 1) / down_;
+        uint64_t produced = output_total_;
+        std::vector<float> silence(taps_, 0.0f);
+        std::vector<float> tail;
+        process(silence.data(), silence.size(), tail);
+        size_t keep = static_cast<size_t>(std::min<uint64_t>(tail.size(), expected > produced ? expected - produced : 0));
+        output.insert(output.end(), tail.begin(), tail.begin() + keep);
+    }
+    reset();
+}
+
+bool AudioUtils::parse_wav(const std::string& data, WavInfo& info) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    const size_t size = data.size();
+    auto u16 = [bytes](size_t at) { return static_cast<uint16_t>(bytes[at] | (bytes[at + 1] << 8)); };
+    auto u32 = [bytes](size_t at) {
+        return static_cast<uint32_t>(bytes[at]) | (static_cast<uint32_t>(bytes[at + 1]) << 8) |
+               (static_cast<uint32_t>(bytes[at + 2]) << 16) | (static_cast<uint32_t>(bytes[at + 3]) << 24);
+    };
+
+    if (size < 12 || std::memcmp(bytes, "RIFF", 4) != 0 || std::memcmp(bytes + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    bool have_fmt = false;
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        uint32_t chunk_size = u32(offset + 4);
+        size_t body = offset + 8;
+
+        if (std::memcmp(bytes + offset, "fmt ", 4) == 0 && chunk_size >= 16 && body + 16 <= size) {
+            info.format = u16(body);
+            info.channels = u16(body + 2);
+            info.sample_rate = u32(body + 4);
+            info.bits_per_sample = u16(body + 14);
+            // WAVE_FORMAT_EXTENSIBLE: the real format is the first field of the subformat GUID
+            if (info.format == 0xFFFE && chunk_size >= 40 && body + 26 <= size) {
+                info.format = u16(body + 24);
+            }
+            have_fmt = true;
+        } else if (std::memcmp(bytes + offset, "data", 4) == 0) {
+            info.data_offset = body;
+            // Streamed WAVs may leave the size unset (0 or 0xFFFFFFFF): take the rest
+            info.data_size = (chunk_size == 0 || body + chunk_size > size) ? size - body : chunk_size;
+            break;
+        }
+
+        offset = body + chunk_size + (chunk_size & 1);  // Chunks are word aligned
+    }
+
+    if (!have_fmt || info.data_offset == 0 || info.channels == 0 || info.sample_rate == 0) {
+        return false;
+    }
+
+    bool pcm = info.format == 1 && (info.bits_per_sample == 8 || info.bits_per_sample == 16 ||
+                                    info.bits_per_sample == 24 || info.bits_per_sample == 32);
+    bool ieee = info.format == 3 && (info.bits_per_sample == 32 || info.bits_per_sample == 64);
+    return pcm || ieee;
+}
+
+bool AudioUtils::to_whisper_wav(const std::string& data, std::string& out) {
+    WavInfo info;
+    if (!parse_wav(data, info)) {
+        return false;
+    }
+    if (info.format == 1 && info.bits_per_sample == 16 && info.channels == 1 &&
+        info.sample_rate == WHISPER_SAMPLE_RATE) {
+        return false;  // Already native
+    }
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data()) + info.data_offset;
+    const size_t sample_bytes = info.bits_per_sample / 8;
+    const size_t frame_bytes = sample_bytes * info.channels;
+    const size_t frames = info.data_size / frame_bytes;
+
+    // Decode and mix down to mono
+    std::vector<float> mono(frames, 0.0f);
+    const float channel_scale = 1.0f / info.channels;
+    for (size_t f = 0; f < frames; f++) {
+        const uint8_t* frame = bytes + f * frame_bytes;
+        float sum = 0.0f;
+        for (size_t c = 0; c < info.channels; c++) {
+            const uint8_t* s = frame + c * sample_bytes;
+            float value = 0.0f;
+            if (info.format == 3) {
+                if (sample_bytes == 4) {
+                    float v;
+                    std::memcpy(&v, s, 4);
+                    value = v;
+                } else {
+                    double v;
+                    std::memcpy(&v, s, 8);
+                    value = static_cast<float>(v);
+                }
+            } else {
+                switch (sample_bytes) {
+                    case 1:
+                        value = (static_cast<int>(s[0]) - 128) / 128.0f;
+                        break;
+                    case 2:
+                        value = static_cast<int16_t>(s[0] | (s[1] << 8)) / 32768.0f;
+                        break;
+                    case 3: {
+                        int32_t v = s[0] | (s[1] << 8) | (s[2] << 16);
+                        if (v & 0x800000) v -= 0x1000000;
+                        value = v / 8388608.0f;
+                        break;
+                    }
+                    default: {
+                        uint32_t u = static_cast<uint32_t>(s[0]) | (static_cast<uint32_t>(s[1]) << 8) |
+                                     (static_cast<uint32_t>(s[2]) << 16) | (static_cast<uint32_t>(s[3]) << 24);
+                        value = static_cast<int32_t>(u) / 2147483648.0f;
+                        break;
+                    }
+                }
+            }
+            sum += value;
+        }
+        mono[f] = sum * channel_scale;
+    }
+
+    if (info.sample_rate != WHISPER_SAMPLE_RATE) {
+        AudioResampler resampler(static_cast<int>(info.sample_rate), WHISPER_SAMPLE_RATE);
+        std::vector<float> resampled;
+        resampled.reserve(static_cast<size_t>(frames * static_cast<double>(WHISPER_SAMPLE_RATE) / info.sample_rate) + 1);
+        resampler.process(mono.data(), mono.size(), resampled);
+        resampler.flush(resampled);
+        mono.swap(resampled);
+    }
+
+    out = encode_wav(mono, WHISPER_SAMPLE_RATE);
+    return true;
+}
+
+std::string AudioUtils::encode_wav(const std::vector<float>& samples, int sample_rate) {
+    std::vector<int16_t> pcm(samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        pcm[i] = to_pcm16(samples[i]);
+    }
+    return encode_wav(pcm.data(), pcm.size(), sample_rate);
+}
+
+std::string AudioUtils::encode_wav(const int16_t* samples, size_t count, int sample_rate) {
+    const uint32_t data_size = static_cast<uint32_t>(count * 2);
+    std::string wav(44 + data_size, '\0');
+    auto* p = reinterpret_cast<uint8_t*>(&wav[0]);
+
+    auto put_u16 = [&p](uint16_t v) { *p++ = v & 0xFF; *p++ = (v >> 8) & 0xFF; };
+    auto put_u32 = [&p](uint32_t v) { for (int i = 0; i < 4; i++) *p++ = (v >> (8 * i)) & 0xFF; };
+    auto put_tag = [&p](const char* tag) { std::memcpy(p, tag, 4); p += 4; };
+
+    put_tag("RIFF");
+    put_u32(36 + data_size);
+    put_tag("WAVE");
+    put_tag("fmt ");
+    put_u32(16);
+    put_u16(1);                                  // PCM
+    put_u16(1);                                  // Mono
+    put_u32(static_cast<uint32_t>(sample_rate));
+    put_u32(static_cast<uint32_t>(sample_rate) * 2);
+    put_u16(2);                                  // Block align
+    put_u16(16);                                 // Bits per sample
+    put_tag("data");
+    put_u32(data_size);
+
+    for (size_t i = 0; i < count; i++) {
+        put_u16(static_cast<uint16_t>(samples[i]));
+    }
+    return wav;
+}
+
+} // namespace utils
+} // namespace lemon
@@ -0,0 +1,26 @@
+#include <lemon/utils/hash_utils.h>
+#include <cstdio>
+
+namespace lemon {
+namespace utils {
+
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+uint64_t fnv1a_64(const std::string& data) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+std::string fnv1a_64_hex(const std::string& data) {
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(fnv1a_64(data)));
+    return hex;
+}
+
+} // namespace utils
+} // namespace lemon
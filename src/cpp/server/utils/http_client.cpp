@@ -7,6 +7,10 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <mutex>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
 
 namespace fs = std::filesystem;
@@ -15,6 +19,7 @@ namespace lemon {
 namespace utils {
 
 long HttpClient::default_timeout_seconds_ = 300;
+std::atomic<int> HttpClient::active_streams_{0};
 
 // Callback for writing response data to string
 static size_t write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
@@ -153,6 +158,29 @@ HttpResponse HttpClient::post(const std::string& url,
     return response;
 }
 
+// Feeds a shared buffer to a curl mime part as it is sent (curl_mime_data would copy it)
+struct MimePartReader {
+    std::shared_ptr<const std::string> data;
+    size_t position = 0;
+};
+
+static size_t mime_part_read(char* buffer, size_t size, size_t nitems, void* arg) {
+    auto* reader = static_cast<MimePartReader*>(arg);
+    size_t count = std::min(size * nitems, reader->data->size() - reader->position);
+    std::memcpy(buffer, reader->data->data() + reader->position, count);
+    reader->position += count;
+    return count;
+}
+
+static int mime_part_seek(void* arg, curl_off_t offset, int origin) {
+    auto* reader = static_cast<MimePartReader*>(arg);
+    if (origin != SEEK_SET || offset < 0 || static_cast<size_t>(offset) > reader->data->size()) {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    reader->position = static_cast<size_t>(offset);
+    return CURL_SEEKFUNC_OK;
+}
+
 HttpResponse HttpClient::post_multipart(const std::string& url,
                                          const std::vector<MultipartField>& fields,
                                          long timeout_seconds) {
@@ -165,11 +193,19 @@ HttpResponse HttpClient::post_multipart(const std::string& url,
     std::string response_body;
 
     curl_mime* mime = curl_mime_init(curl);
+    std::vector<std::unique_ptr<MimePartReader>> readers;  // Must outlive the transfer
 
     for (const auto& field : fields) {
         curl_mimepart* part = curl_mime_addpart(mime);
         curl_mime_name(part, field.name.c_str());
-        curl_mime_data(part, field.data.c_str(), field.data.size());
+        if (field.shared_data) {
+            readers.push_back(std::make_unique<MimePartReader>());
+            readers.back()->data = field.shared_data;
+            curl_mime_data_cb(part, static_cast<curl_off_t>(field.shared_data->size()),
+                              mime_part_read, mime_part_seek, nullptr, readers.back().get());
+        } else {
+            curl_mime_data(part, field.data.c_str(), field.data.size());
+        }
         if (!field.filename.empty()) {
             curl_mime_filename(part, field.filename.c_str());
         }
@@ -209,7 +245,6 @@ HttpResponse HttpClient::post_multipart(const std::string& url,
 // Helper struct to pass stream callback through C interface
 struct StreamCallbackData {
     StreamCallback* callback;
-    std::string* buffer;
 };
 
 // Static C-style callback function
@@ -237,6 +272,31 @@ static size_t stream_write_callback(char* ptr, size_t size, size_t nmemb, void*
     }
 }
 
+// Streams share one connection cache, so keep-alive connections to the wrapped servers
+// are reused instead of opening a new socket per request
+static std::mutex share_locks[CURL_LOCK_DATA_LAST];
+
+static void share_lock(CURL*, curl_lock_data data, curl_lock_access, void*) {
+    share_locks[data].lock();
+}
+
+static void share_unlock(CURL*, curl_lock_data data, void*) {
+    share_locks[data].unlock();
+}
+
+static CURLSH* stream_share() {
+    static CURLSH* share = [] {
+        CURLSH* handle = curl_share_init();
+        if (handle) {
+            curl_share_setopt(handle, CURLSHOPT_LOCKFUNC, share_lock);
+            curl_share_setopt(handle, CURLSHOPT_UNLOCKFUNC, share_unlock);
+            curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        }
+        return handle;
+    }();
+    return share;
+}
+
 HttpResponse HttpClient::post_stream(const std::string& url,
                                      const std::string& body,
                                      StreamCallback stream_callback,
@@ -252,15 +312,23 @@ HttpResponse HttpClient::post_stream(const std::string& url,
     // Create callback data
     StreamCallbackData callback_data;
     callback_data.callback = &stream_callback;
-    callback_data.buffer = nullptr;
 
+    // Chunks are written to the client from the write callback. A client that reads slowly
+    // blocks the callback, so curl stops reading from the backend and nothing piles up here;
+    // one that stops reading fails the write after --stream-stall-timeout, which aborts the
+    // backend request and frees its slot.
     curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
     curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(body.size()));
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, stream_write_callback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &callback_data);
     // Use provided timeout, or fallback to global default (set via --http-timeout)
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout_seconds > 0 ? timeout_seconds : default_timeout_seconds_);
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "lemon.cpp/1.0");
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    if (CURLSH* share = stream_share()) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share);
+    }
 
     // Add custom headers
     struct curl_slist* header_list = nullptr;
@@ -271,7 +339,9 @@ HttpResponse HttpClient::post_stream(const std::string& url,
     }
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
 
+    active_streams_++;
     CURLcode res = curl_easy_perform(curl);
+    active_streams_--;
 
     // Get response code before checking for errors
     long response_code;
@@ -3,6 +3,7 @@
 #include <fstream>
 #include <stdexcept>
 #include <vector>
+#include <algorithm>
 
 namespace lemon {
 namespace utils {
@@ -70,6 +71,93 @@ bool JsonUtils::has_key(const json& j, const std::string& key) {
     return j.contains(key) && !j[key].is_null();
 }
 
+namespace {
+
+// SAX handler that records selected top-level scalars and aborts once all are found
+class FieldScanner : public nlohmann::json_sax<json> {
+public:
+    FieldScanner(const std::vector<std::string>& keys, json& out) : keys_(keys), out_(out) {}
+
+    bool null() override { return scalar(nullptr); }
+    bool boolean(bool val) override { return scalar(val); }
+    bool number_integer(number_integer_t val) override { return scalar(val); }
+    bool number_unsigned(number_unsigned_t val) override { return scalar(val); }
+    bool number_float(number_float_t val, const string_t&) override { return scalar(val); }
+    bool string(string_t& val) override { return scalar(std::move(val)); }
+    bool binary(binary_t&) override { return scalar(nullptr); }
+
+    bool start_object(std::size_t) override { return nested(); }
+    bool start_array(std::size_t) override { return nested(); }
+    bool end_object() override { depth_--; return true; }
+    bool end_array() override { depth_--; return true; }
+
+    bool key(string_t& val) override {
+        wanted_ = depth_ == 1 &&
+                  std::find(keys_.begin(), keys_.end(), val) != keys_.end() &&
+                  !out_.contains(val);
+        if (wanted_) {
+            current_key_ = val;
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override {
+        return false;
+    }
+
+private:
+    bool scalar(json value) {
+        if (wanted_) {
+            out_[current_key_] = std::move(value);
+            wanted_ = false;
+            return out_.size() < keys_.size();  // Stop early once everything is found
+        }
+        return true;
+    }
+
+    bool nested() {
+        wanted_ = false;  // Only scalars are reported
+        depth_++;
+        return true;
+    }
+
+    const std::vector<std::string>& keys_;
+    json& out_;
+    int depth_ = 0;
+    bool wanted_ = false;
+    std::string current_key_;
+};
+
+} // namespace
+
+json JsonUtils::scan_fields(const std::string& json_str, const std::vector<std::string>& keys) {
+    json result = json::object();
+    if (keys.empty()) {
+        return result;
+    }
+
+    FieldScanner scanner(keys, result);
+    json::sax_parse(json_str, &scanner);
+    return result;
+}
+
+bool JsonUtils::insert_field(std::string& json_str, const std::string& key, const json& value) {
+    size_t open = json_str.find_first_not_of(" \t\r\n");
+    if (open == std::string::npos || json_str[open] != '{') {
+        return false;
+    }
+
+    size_t next = json_str.find_first_not_of(" \t\r\n", open + 1);
+    bool empty_object = next != std::string::npos && json_str[next] == '}';
+
+    std::string field = json(key).dump() + ":" + value.dump();
+    if (!empty_object) {
+        field += ",";
+    }
+    json_str.insert(open + 1, field);
+    return true;
+}
+
 std::string JsonUtils::base64_encode(const std::string& input) {
     static const char base64_chars[] =
         "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
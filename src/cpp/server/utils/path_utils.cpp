@@ -4,12 +4,18 @@
 #include <vector>
 #include <string>
 #include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <mutex>
 
 #ifdef _WIN32
 #include <windows.h>
 #else
 #include <unistd.h>
 #include <limits.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #ifdef __APPLE__
 #include <unistd.h>
 #include <sys/types.h>
@@ -402,6 +408,120 @@ std::string get_runtime_dir() {
 #endif
 }
 
+#ifndef _WIN32
+// Directory for the socket when there is no XDG runtime directory. /tmp itself is writable by
+// everyone, so another user could bind the predictable socket name first; a 0700 directory
+// owned by us cannot be entered by them. lstat() refuses a symlink planted in its place.
+static std::string get_private_socket_dir() {
+    std::string dir = "/tmp/lemonade-" + std::to_string(geteuid());
+    mkdir(dir.c_str(), 0700);
+
+    struct stat st;
+    if (lstat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) ||
+        st.st_uid != geteuid() || (st.st_mode & 077) != 0) {
+        return "";
+    }
+    return dir;
+}
+
+// Only a socket created by the current user (or root) may be trusted with requests
+static bool is_trusted_socket(const struct stat& st) {
+    return S_ISSOCK(st.st_mode) && (st.st_uid == geteuid() || st.st_uid == 0);
+}
+#endif
+
+std::string get_unix_socket_path(int port, const std::string& setting) {
+#ifdef _WIN32
+    (void)port;
+    (void)setting;
+    return "";
+#else
+    if (setting == "off") {
+        return "";
+    }
+    if (!setting.empty() && setting != "auto") {
+        return setting;
+    }
+
+    std::string dir = get_runtime_dir();
+    if (dir == "/tmp") {
+        dir = get_private_socket_dir();
+        if (dir.empty()) {
+            return "";  // Not safe to listen; clients use TCP
+        }
+    }
+    return dir + "/lemonade-" + std::to_string(port) + ".sock";
+#endif
+}
+
+bool is_unix_socket_listening(const std::string& path) {
+#ifdef _WIN32
+    (void)path;
+    return false;
+#else
+    struct sockaddr_un addr = {};
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return false;
+    }
+    bool connected = connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0;
+    close(sock);
+    return connected;
+#endif
+}
+
+std::string find_router_unix_socket(const std::string& host, int port) {
+    if (!host.empty() && host != "localhost" && host != "127.0.0.1" &&
+        host != "0.0.0.0" && host != "::1" && host != "::") {
+        return "";
+    }
+
+    std::string path = get_unix_socket_path(port, get_environment_variable_utf8("LEMONADE_UNIX_SOCKET"));
+#ifdef _WIN32
+    return "";
+#else
+    struct stat st;
+    if (path.empty() || lstat(path.c_str(), &st) != 0 || !is_trusted_socket(st)) {
+        return "";
+    }
+
+    // Clients build a connection per request, and a probe connect() costs a round trip to
+    // the router. Reuse the answer while the same socket file is there; a restarted router
+    // creates a new file.
+    static const auto PROBE_TTL = std::chrono::seconds(10);
+    static std::mutex probe_mutex;
+    static std::string probed_path;
+    static dev_t probed_dev = 0;
+    static ino_t probed_ino = 0;
+    static bool probed_listening = false;
+    static std::chrono::steady_clock::time_point probed_at;
+
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(probe_mutex);
+        if (probed_path == path && probed_dev == st.st_dev && probed_ino == st.st_ino &&
+            now - probed_at < PROBE_TTL) {
+            return probed_listening ? path : "";
+        }
+    }
+
+    bool listening = is_unix_socket_listening(path);
+    std::lock_guard<std::mutex> lock(probe_mutex);
+    probed_path = path;
+    probed_dev = st.st_dev;
+    probed_ino = st.st_ino;
+    probed_listening = listening;
+    probed_at = now;
+    return listening ? path : "";
+#endif
+}
+
 std::string get_downloaded_bin_dir() {
     // Use cache directory on all platforms for consistent multi-user support
     // This is important for All Users installs on Windows where Program Files is read-only
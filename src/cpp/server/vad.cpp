@@ -1,9 +1,25 @@
 #include "lemon/vad.h"
 #include <cmath>
 #include <chrono>
+#include <algorithm>
 
 namespace lemon {
 
+static const float PI = 3.14159265358979f;
+
+int64_t VoiceActivityDetector::current_time_ms() {
+    auto now = std::chrono::system_clock::now();
+    auto duration = now.time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+}
+
+void VoiceActivityDetector::reset() {
+    speech_active_ = false;
+    speech_start_ms_ = 0;
+    speech_end_ms_ = 0;
+    last_rms_ = 0.0f;
+}
+
 SimpleVAD::SimpleVAD()
     : config_() {
 }
@@ -24,10 +40,10 @@ float SimpleVAD::calculate_rms(const std::vector<float>& audio) {
     return std::sqrt(sum_squares / static_cast<float>(audio.size()));
 }
 
-int64_t SimpleVAD::current_time_ms() {
-    auto now = std::chrono::system_clock::now();
-    auto duration = now.time_since_epoch();
-    return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+SimpleVAD::Event SimpleVAD::process(const StreamingAudioBuffer& buffer) {
+    // Get recent audio for VAD processing (last 100ms)
+    buffer.get_recent_samples(100, recent_);
+    return process(recent_, StreamingAudioBuffer::SAMPLE_RATE);
 }
 
 SimpleVAD::Event SimpleVAD::process(const std::vector<float>& audio, int sample_rate) {
@@ -37,6 +53,7 @@ SimpleVAD::Event SimpleVAD::process(const std::vector<float>& audio, int sample_
 
     // Calculate RMS energy of this chunk
     float rms = calculate_rms(audio);
+    last_rms_ = rms;
     bool is_voice = rms > config_.energy_threshold;
 
     // Calculate frame duration in milliseconds
@@ -97,13 +114,216 @@ SimpleVAD::Event SimpleVAD::process(const std::vector<float>& audio, int sample_
 }
 
 void SimpleVAD::reset() {
-    speech_active_ = false;
-    speech_start_ms_ = 0;
-    speech_end_ms_ = 0;
+    VoiceActivityDetector::reset();
     speech_frames_ = 0;
     silence_frames_ = 0;
     onset_counter_ = 0;
     hangover_counter_ = 0;
 }
 
+SpectralVAD::SpectralVAD()
+    : SpectralVAD(Config{}) {
+}
+
+SpectralVAD::SpectralVAD(const Config& config) {
+    set_config(config);
+}
+
+void SpectralVAD::set_config(const Config& config) {
+    config_ = config;
+    config_.frame_ms = std::max(10, std::min(30, config_.frame_ms));
+    frame_size_ = static_cast<size_t>(config_.sample_rate) * config_.frame_ms / 1000;
+
+    size_t fft_size = 1;
+    while (fft_size < frame_size_) {
+        fft_size <<= 1;
+    }
+
+    window_.resize(frame_size_);
+    for (size_t i = 0; i < frame_size_; i++) {
+        window_[i] = 0.5f - 0.5f * std::cos(2.0f * PI * i / (frame_size_ - 1));
+    }
+
+    twiddle_re_.resize(fft_size / 2);
+    twiddle_im_.resize(fft_size / 2);
+    for (size_t k = 0; k < fft_size / 2; k++) {
+        twiddle_re_[k] = std::cos(-2.0f * PI * k / fft_size);
+        twiddle_im_[k] = std::sin(-2.0f * PI * k / fft_size);
+    }
+
+    re_.assign(fft_size, 0.0f);
+    im_.assign(fft_size, 0.0f);
+    reset();
+}
+
+void SpectralVAD::reset() {
+    VoiceActivityDetector::reset();
+    position_ = 0;
+    pending_.clear();
+    voiced_ms_ = 0;
+    silence_ms_ = 0;
+    // The noise floor describes the room, not the utterance, so it survives resets
+}
+
+void SpectralVAD::fft(std::vector<float>& re, std::vector<float>& im,
+                      const std::vector<float>& twiddle_re, const std::vector<float>& twiddle_im) {
+    const size_t n = re.size();
+
+    // Bit-reversal permutation
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    // Iterative radix-2 butterflies
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2;
+        size_t stride = n / len;
+        for (size_t start = 0; start < n; start += len) {
+            for (size_t k = 0; k < half; k++) {
+                float wr = twiddle_re[k * stride];
+                float wi = twiddle_im[k * stride];
+                size_t a = start + k;
+                size_t b = a + half;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+SpectralVAD::Features SpectralVAD::analyze_frame(const float* frame) {
+    const size_t n = frame_size_;
+
+    // Energy, zero crossings and windowing are written as straight-line loops over
+    // contiguous floats so the compiler vectorizes them (SSE/AVX/NEON)
+    float energy = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        energy += frame[i] * frame[i];
+    }
+
+    int crossings = 0;
+    for (size_t i = 1; i < n; i++) {
+        crossings += (frame[i - 1] * frame[i]) < 0.0f;
+    }
+
+    float* re = re_.data();
+    const float* window = window_.data();
+    for (size_t i = 0; i < n; i++) {
+        re[i] = frame[i] * window[i];
+    }
+    std::fill(re_.begin() + n, re_.end(), 0.0f);
+    std::fill(im_.begin(), im_.end(), 0.0f);
+    fft(re_, im_, twiddle_re_, twiddle_im_);
+
+    // Spectral flatness over the speech band (~250-4000 Hz): geometric / arithmetic mean
+    const size_t fft_size = re_.size();
+    size_t lo = std::max<size_t>(1, 250 * fft_size / config_.sample_rate);
+    size_t hi = std::min(fft_size / 2, 4000 * fft_size / config_.sample_rate);
+    float log_sum = 0.0f;
+    float power_sum = 0.0f;
+    for (size_t k = lo; k < hi; k++) {
+        float power = re_[k] * re_[k] + im_[k] * im_[k] + 1e-12f;
+        log_sum += std::log(power);
+        power_sum += power;
+    }
+    float bins = static_cast<float>(hi - lo);
+
+    float mean_square = energy / n;
+    last_rms_ = std::sqrt(mean_square);
+
+    Features features;
+    features.log_energy_db = 10.0f * std::log10(mean_square + 1e-10f);
+    features.flatness = std::exp(log_sum / bins) / (power_sum / bins);
+    features.zcr = static_cast<float>(crossings) / static_cast<float>(n - 1);
+    return features;
+}
+
+SpectralVAD::Event SpectralVAD::process_frame(const float* frame) {
+    // Digital silence would drag the noise floor to -100 dB and make any sound "speech"
+    static const float MIN_NOISE_FLOOR_DB = -70.0f;
+
+    Features f = analyze_frame(frame);
+
+    if (!noise_initialized_) {
+        noise_floor_db_ = std::max(f.log_energy_db, MIN_NOISE_FLOOR_DB);
+        noise_initialized_ = true;
+    }
+
+    float snr_db = f.log_energy_db - noise_floor_db_;
+    bool loud = snr_db >= config_.snr_threshold_db;
+    bool voiced = loud && f.flatness <= config_.flatness_threshold;
+    bool fricative = loud && f.zcr >= config_.fricative_zcr;
+    bool is_speech = voiced || (speech_active_ && fricative);
+
+    // Noise floor: follow quieter frames immediately, louder non-speech frames slowly
+    if (f.log_energy_db < noise_floor_db_) {
+        noise_floor_db_ = std::max(f.log_energy_db, MIN_NOISE_FLOOR_DB);
+    } else if (!is_speech && !speech_active_) {
+        noise_floor_db_ += config_.noise_rise_rate * (f.log_energy_db - noise_floor_db_);
+    }
+
+    Event result = Event::None;
+
+    if (!speech_active_) {
+        // Onset: accumulate voiced audio, decaying (not resetting) on gaps between syllables
+        voiced_ms_ = voiced ? voiced_ms_ + config_.frame_ms : std::max(0, voiced_ms_ - config_.frame_ms);
+        if (voiced_ms_ >= config_.min_speech_ms) {
+            speech_active_ = true;
+            silence_ms_ = 0;
+            speech_start_ms_ = current_time_ms() - voiced_ms_;
+            result = Event::SpeechStart;
+        }
+    } else if (is_speech) {
+        silence_ms_ = 0;
+    } else {
+        silence_ms_ += config_.frame_ms;
+        if (silence_ms_ >= config_.min_silence_ms) {
+            speech_active_ = false;
+            speech_end_ms_ = current_time_ms();
+            voiced_ms_ = 0;
+            silence_ms_ = 0;
+            result = Event::SpeechEnd;
+        }
+    }
+
+    return result;
+}
+
+SpectralVAD::Event SpectralVAD::process(const StreamingAudioBuffer& buffer) {
+    if (buffer.sample_count() < position_) {
+        // Buffer was cleared without a reset
+        position_ = 0;
+        pending_.clear();
+    }
+
+    buffer.get_samples_from(position_, fresh_);
+    position_ += fresh_.size();
+    pending_.insert(pending_.end(), fresh_.begin(), fresh_.end());
+
+    Event result = Event::None;
+    size_t offset = 0;
+    while (pending_.size() - offset >= frame_size_) {
+        result = process_frame(pending_.data() + offset);
+        offset += frame_size_;
+        if (result != Event::None) {
+            break;  // Report one boundary per call; the rest is examined next time
+        }
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + offset);
+
+    return result;
+}
+
 } // namespace lemon
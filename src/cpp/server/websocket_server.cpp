@@ -51,8 +51,7 @@ bool WebSocketServer::start() {
 
                 case ix::WebSocketMessageType::Message: {
                     if (msg->binary) {
-                        // Binary messages not supported for now
-                        LOG(ERROR, "WebSocket") << "Received unsupported binary message" << std::endl;
+                        handle_binary_message(conn_id, msg->str);
                     } else {
                         handle_message(conn_id, msg->str);
                     }
@@ -126,6 +125,15 @@ void WebSocketServer::handle_connection(const std::string& connection_id, ix::We
         LOG(INFO, "WebSocket") << "Model from URL: " << params["model"] << std::endl;
     }
 
+    // Sample rate of the client's PCM16 audio (defaults to 16kHz)
+    if (params.count("sample_rate")) {
+        try {
+            initial_config["input_sample_rate"] = std::stoi(params["sample_rate"]);
+        } catch (const std::exception&) {
+            LOG(WARNING, "WebSocket") << "Ignoring invalid sample_rate: " << params["sample_rate"] << std::endl;
+        }
+    }
+
     // Store WebSocket pointer for this connection
     {
         std::lock_guard<std::mutex> lock(connections_mutex_);
@@ -184,10 +192,13 @@ void WebSocketServer::handle_message(const std::string& connection_id, const std
         session_manager_->update_session(session_id, session_config);
     }
     else if (msg_type == "input_audio_buffer.append") {
-        // Append audio data
-        std::string audio = request.value("audio", "");
-        if (!audio.empty()) {
-            session_manager_->append_audio(session_id, audio);
+        // Append audio data (by reference: chunks are decoded straight out of the parsed message)
+        auto audio = request.find("audio");
+        if (audio != request.end() && audio->is_string()) {
+            const auto& base64_audio = audio->get_ref<const std::string&>();
+            if (!base64_audio.empty()) {
+                session_manager_->append_audio(session_id, base64_audio);
+            }
         }
     }
     else if (msg_type == "input_audio_buffer.commit") {
@@ -211,6 +222,35 @@ void WebSocketServer::handle_message(const std::string& connection_id, const std
     }
 }
 
+void WebSocketServer::handle_binary_message(const std::string& connection_id, const std::string& data) {
+    std::string session_id;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        auto it = connection_sessions_.find(connection_id);
+        if (it == connection_sessions_.end()) {
+            LOG(ERROR, "WebSocket") << "Message from unknown connection" << std::endl;
+            return;
+        }
+        session_id = it->second;
+    }
+
+    // A binary frame is the payload of an input_audio_buffer.append: little-endian PCM16 mono
+    // at the session's input_sample_rate (resampled on append), so it must hold whole samples
+    if (data.size() % 2 != 0) {
+        json error_msg = {
+            {"type", "error"},
+            {"error", {
+                {"message", "Binary audio frames must contain whole PCM16 samples (even byte count)"},
+                {"type", "invalid_request_error"}
+            }}
+        };
+        send_json(connection_id, error_msg);
+        return;
+    }
+
+    session_manager_->append_audio_raw(session_id, reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
 void WebSocketServer::handle_close(const std::string& connection_id) {
     std::string session_id;
     {
@@ -0,0 +1,195 @@
+#include <lemon/worker_pool.h>
+#include <lemon/utils/aixlog.hpp>
+#include <algorithm>
+#include <chrono>
+
+namespace lemon {
+
+// How long an extra worker (above min_threads) waits for work before exiting
+static const std::chrono::seconds IDLE_WORKER_TIMEOUT(30);
+
+// Requests served so far on the connection this worker is handling (nullptr between connections)
+static thread_local uint64_t* current_connection_requests = nullptr;
+
+WorkerPool::WorkerPool(size_t min_threads, size_t max_threads)
+    : min_threads_(std::max<size_t>(1, min_threads)),
+      max_threads_(std::max(std::max<size_t>(1, min_threads), max_threads)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < min_threads_; i++) {
+        spawn_worker();
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    shutdown();
+}
+
+bool WorkerPool::enqueue(std::function<void()> fn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (shutdown_) {
+            return false;
+        }
+
+        jobs_.push_back(std::move(fn));
+        jobs_total_++;
+
+        // Every worker is tied up (typically by streams): grow instead of making this job wait
+        if (idle_ < jobs_.size()) {
+            if (threads_ < max_threads_) {
+                reap_finished();
+                spawn_worker();
+            } else {
+                jobs_queued_at_max_++;
+                LOG(WARNING, "WorkerPool") << "All " << max_threads_
+                                           << " HTTP workers busy, request queued" << std::endl;
+            }
+        }
+    }
+    cv_.notify_one();
+    return true;
+}
+
+void WorkerPool::shutdown() {
+    std::list<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (shutdown_ && workers_.empty()) {
+            return;
+        }
+        shutdown_ = true;
+        workers.swap(workers_);
+        finished_.clear();
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+json WorkerPool::get_stats() const {
+    uint64_t closed = connections_closed_.load();
+    uint64_t requests = connection_requests_.load();
+    json connections = {
+        {"accepted", connections_accepted_.load()},
+        {"active", connections_active_.load()},
+        {"closed", closed},
+        {"requests_per_connection", closed > 0 ? (double) requests / closed : 0.0},
+        {"max_requests_per_connection", max_requests_per_connection_.load()}
+    };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {
+        {"threads", threads_},
+        {"busy", threads_ - idle_},
+        {"queued", jobs_.size()},
+        {"min_threads", min_threads_},
+        {"max_threads", max_threads_},
+        {"peak_threads", peak_threads_},
+        {"jobs_total", jobs_total_.load()},
+        {"jobs_queued_at_max", jobs_queued_at_max_.load()},
+        {"connections", connections}
+    };
+}
+
+void WorkerPool::note_request() {
+    if (current_connection_requests) {
+        (*current_connection_requests)++;
+    }
+}
+
+bool WorkerPool::Queue::enqueue(std::function<void()> fn) {
+    auto pool = pool_;
+    pool->connections_accepted_++;
+    return pool->enqueue([pool, fn = std::move(fn)]() { pool->serve_connection(fn); });
+}
+
+void WorkerPool::serve_connection(const std::function<void()>& fn) {
+    uint64_t requests = 0;
+    current_connection_requests = &requests;
+    connections_active_++;
+
+    auto finish = [&] {
+        current_connection_requests = nullptr;
+        connections_active_--;
+        connections_closed_++;
+        connection_requests_ += requests;
+        uint64_t max = max_requests_per_connection_.load();
+        while (requests > max && !max_requests_per_connection_.compare_exchange_weak(max, requests)) {}
+    };
+
+    try {
+        fn();
+    } catch (...) {
+        finish();
+        throw;
+    }
+    finish();
+}
+
+void WorkerPool::spawn_worker() {
+    threads_++;
+    idle_++;  // Counted idle until it picks up a job
+    peak_threads_ = std::max(peak_threads_, threads_);
+    workers_.emplace_back(&WorkerPool::worker_loop, this);
+}
+
+void WorkerPool::reap_finished() {
+    for (const auto& id : finished_) {
+        auto it = std::find_if(workers_.begin(), workers_.end(),
+                               [&id](const std::thread& t) { return t.get_id() == id; });
+        if (it != workers_.end()) {
+            it->join();
+            workers_.erase(it);
+        }
+    }
+    finished_.clear();
+}
+
+void WorkerPool::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        bool has_work = cv_.wait_for(lock, IDLE_WORKER_TIMEOUT,
+                                     [this] { return shutdown_ || !jobs_.empty(); });
+
+        if (!has_work) {
+            // Timed out: shrink back towards min_threads
+            if (threads_ > min_threads_) {
+                break;
+            }
+            continue;
+        }
+
+        if (jobs_.empty()) {
+            break;  // Shutdown with nothing left to do
+        }
+
+        auto job = std::move(jobs_.front());
+        jobs_.pop_front();
+        idle_--;
+
+        lock.unlock();
+        try {
+            job();
+        } catch (const std::exception& e) {
+            LOG(ERROR, "WorkerPool") << "Unhandled exception in HTTP worker: " << e.what() << std::endl;
+        } catch (...) {
+            LOG(ERROR, "WorkerPool") << "Unhandled exception in HTTP worker" << std::endl;
+        }
+        lock.lock();
+
+        idle_++;
+    }
+
+    threads_--;
+    idle_--;
+    if (!shutdown_) {
+        finished_.push_back(std::this_thread::get_id());
+    }
+}
+
+} // namespace lemon
@@ -3,6 +3,7 @@
 #include <lemon/utils/http_client.h>
 #include <lemon/streaming_proxy.h>
 #include <lemon/error_types.h>
+#include <lemon/tracing.h>
 #include <httplib.h>
 #include <thread>
 #include <chrono>
@@ -79,6 +80,7 @@ json WrappedServer::forward_request(const std::string& endpoint, const json& req
 
     std::string url = get_base_url() + endpoint;
     std::map<std::string, std::string> headers = {{"Content-Type", "application/json"}};
+    tracing::Span span("backend_request", server_name_ + " " + endpoint);
 
     try {
         auto response = utils::HttpClient::post(url, request.dump(), headers,
@@ -117,6 +119,7 @@ json WrappedServer::forward_multipart_request(const std::string& endpoint,
     }
 
     std::string url = get_base_url() + endpoint;
+    tracing::Span span("backend_request", server_name_ + " " + endpoint);
 
     try {
         auto response = utils::HttpClient::post_multipart(url, fields,
@@ -148,52 +151,73 @@ json WrappedServer::forward_multipart_request(const std::string& endpoint,
     }
 }
 
+// Report a failure inside an already started stream
+static void send_stream_error(httplib::DataSink& sink, const std::string& message, const std::string& type) {
+    try {
+        std::string error_msg = "data: {\"error\":{\"message\":\"" + message +
+                               "\",\"type\":\"" + type + "\"}}\n\n";
+        sink.write(error_msg.c_str(), error_msg.size());
+        sink.done();
+    } catch (...) {
+        // Sink might be closed, ignore
+    }
+}
+
 void WrappedServer::forward_streaming_request(const std::string& endpoint,
                                               const std::string& request_body,
                                               httplib::DataSink& sink,
                                               bool sse,
                                               long timeout_seconds) {
+    if (!sse) {
+        forward_byte_stream(endpoint, request_body, sink, timeout_seconds);
+        return;
+    }
+
     if (!is_process_running()) {
-        std::string error_msg = "data: {\"error\":{\"message\":\"No model loaded: " + server_name_ +
-                               "\",\"type\":\"model_not_loaded\"}}\n\n";
-        sink.write(error_msg.c_str(), error_msg.size());
-        sink.done();
+        send_stream_error(sink, "No model loaded: " + server_name_, "model_not_loaded");
         return;
     }
 
     std::string url = get_base_url() + endpoint;
 
     try {
-
-        if (sse) {
-            // Use StreamingProxy to forward the SSE stream with telemetry callback
-            // Use INFERENCE_TIMEOUT_SECONDS (0 = infinite) as chat completions can take a long time
-            StreamingProxy::forward_sse_stream(url, request_body, sink,
-                [this](const StreamingProxy::TelemetryData& telemetry) {
-                    // Save telemetry to member variable
-                    telemetry_.input_tokens = telemetry.input_tokens;
-                    telemetry_.output_tokens = telemetry.output_tokens;
-                    telemetry_.time_to_first_token = telemetry.time_to_first_token;
-                    telemetry_.tokens_per_second = telemetry.tokens_per_second;
-                    // Note: decode_token_times is not available from streaming proxy
-                },
-                timeout_seconds
-            );
-        } else {
-            StreamingProxy::forward_byte_stream(url, request_body, sink, timeout_seconds);
-        }
+        // Use StreamingProxy to forward the SSE stream with telemetry callback
+        // Use INFERENCE_TIMEOUT_SECONDS (0 = infinite) as chat completions can take a long time
+        StreamingProxy::forward_sse_stream(url, request_body, sink,
+            [this](const StreamingProxy::TelemetryData& telemetry) {
+                // Save telemetry to member variable
+                telemetry_.input_tokens = telemetry.input_tokens;
+                telemetry_.output_tokens = telemetry.output_tokens;
+                telemetry_.time_to_first_token = telemetry.time_to_first_token;
+                telemetry_.tokens_per_second = telemetry.tokens_per_second;
+                telemetry_.draft_tokens = telemetry.draft_tokens;
+                telemetry_.draft_tokens_accepted = telemetry.draft_tokens_accepted;
+                // Note: decode_token_times is not available from streaming proxy
+            },
+            timeout_seconds
+        );
     } catch (const std::exception& e) {
         // Log the error but don't crash the server
         LOG(ERROR, "WrappedServer") << "Streaming request failed: " << e.what() << std::endl;
-        // Try to send error to client if possible
-        try {
-            std::string error_msg = "data: {\"error\":{\"message\":\"" + std::string(e.what()) +
-                                   "\",\"type\":\"streaming_error\"}}\n\n";
-            sink.write(error_msg.c_str(), error_msg.size());
-            sink.done();
-        } catch (...) {
-            // Sink might be closed, ignore
-        }
+        send_stream_error(sink, e.what(), "streaming_error");
+    }
+}
+
+bool WrappedServer::forward_byte_stream(const std::string& endpoint,
+                                        const std::string& request_body,
+                                        httplib::DataSink& sink,
+                                        long timeout_seconds) {
+    if (!is_process_running()) {
+        send_stream_error(sink, "No model loaded: " + server_name_, "model_not_loaded");
+        return false;
+    }
+
+    try {
+        return StreamingProxy::forward_byte_stream(get_base_url() + endpoint, request_body, sink, timeout_seconds);
+    } catch (const std::exception& e) {
+        LOG(ERROR, "WrappedServer") << "Streaming request failed: " << e.what() << std::endl;
+        send_stream_error(sink, e.what(), "streaming_error");
+        return false;
     }
 }
 
@@ -775,8 +775,13 @@ void ServerManager::remove_pid_file() {
 #endif
 
 httplib::Client ServerManager::make_http_client(int timeout_seconds, int connection_timeout) {
-    // Use the configured host to connect to the server
-    httplib::Client cli(get_connection_host(), port_);
+    // Prefer the router's Unix socket for a local server, else the configured host
+    std::string socket_path = lemon::utils::find_router_unix_socket(host_, port_);
+    httplib::Client cli = socket_path.empty() ? httplib::Client(get_connection_host(), port_)
+                                              : httplib::Client(socket_path, port_);
+    if (!socket_path.empty()) {
+        cli.set_address_family(AF_UNIX);
+    }
     cli.set_connection_timeout(connection_timeout, 0);
     cli.set_read_timeout(timeout_seconds, 0);  // Configurable read timeout
 
@@ -30,7 +30,8 @@ module.exports = (env, argv) => ({
         test: /\.(png|jpg|jpeg|gif|ico|woff|woff2|ttf|eot)$/,
         type: 'asset/resource',
         generator: {
-          filename: '[name][ext]'
+          // Content hash in the name lets the server mark these immutable
+          filename: '[name].[contenthash:8][ext]'
         }
       },
       {
@@ -56,7 +57,8 @@ module.exports = (env, argv) => ({
     },
   },
   output: {
-    filename: 'renderer.bundle.js',
+    // Content-hashed so the server can cache it as immutable; index.html picks up the new name
+    filename: 'renderer.[contenthash:8].js',
     path: process.env.WEBPACK_OUTPUT_PATH || path.resolve(__dirname, 'dist/renderer'),
   },
   plugins: [
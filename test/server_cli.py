@@ -773,6 +773,79 @@ class EphemeralCLITests(CLITestBase):
         )
         print(f"[OK] recipes --install {target} works without persistent server")
 
+    @unittest.skipIf(os.name == "nt", "Unix domain sockets are not available on Windows")
+    def test_010_unix_socket(self):
+        """Test that serve --unix-socket answers HTTP requests on the socket."""
+        self.assertFalse(is_server_running(), "Server should not be running")
+
+        socket_dir = tempfile.mkdtemp()
+        socket_path = os.path.join(socket_dir, "lemonade-test.sock")
+        cmd = [
+            _config["server_binary"],
+            "serve",
+            "--port",
+            str(PORT),
+            "--unix-socket",
+            socket_path,
+        ]
+        if os.getenv("LEMONADE_CI_MODE"):
+            cmd.append("--no-tray")
+
+        server_process = subprocess.Popen(
+            cmd,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.PIPE,
+            text=True,
+        )
+
+        try:
+            self.assertTrue(wait_for_server_start(), "Server should start")
+
+            # The socket listener starts alongside TCP; wait for /health to report it
+            health = {}
+            for _ in range(50):
+                with urllib.request.urlopen(
+                    f"http://localhost:{PORT}/api/v1/health", timeout=TIMEOUT_DEFAULT
+                ) as resp:
+                    health = json.loads(resp.read())
+                if "unix_socket" in health:
+                    break
+                time.sleep(0.1)
+            self.assertEqual(health.get("unix_socket"), socket_path)
+            self.assertIn("unix", health.get("http_workers", {}))
+
+            # Only the user running the server may connect
+            self.assertEqual(os.stat(socket_path).st_mode & 0o077, 0)
+
+            with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as client:
+                client.settimeout(TIMEOUT_DEFAULT)
+                client.connect(socket_path)
+                client.sendall(
+                    b"GET /live HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n"
+                )
+                reply = b""
+                while True:
+                    chunk = client.recv(4096)
+                    if not chunk:
+                        break
+                    reply += chunk
+
+            self.assertTrue(
+                reply.startswith(b"HTTP/1.1 200"),
+                f"Unexpected reply on the Unix socket: {reply[:200]!r}",
+            )
+            print(f"[OK] Server answers on Unix socket {socket_path}")
+
+        finally:
+            server_process.terminate()
+            try:
+                server_process.wait(timeout=5)
+            except subprocess.TimeoutExpired:
+                server_process.kill()
+            if os.path.exists(socket_path):
+                os.remove(socket_path)
+            os.rmdir(socket_dir)
+
 
 def run_cli_tests():
     """
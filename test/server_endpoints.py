@@ -11,6 +11,7 @@ Tests endpoints that don't require specific inference backends:
 - /system-info
 - /stats
 - /live
+- /debug/trace
 
 Usage:
     python server_endpoints.py
@@ -21,6 +22,7 @@ Usage:
 import json
 import platform
 import os
+import time
 import requests
 from openai import NotFoundError
 
@@ -1112,6 +1114,90 @@ class EndpointTests(ServerTestBase):
         )
         print("[OK] system-info contains release_url for backends")
 
+    def test_030_priority_header(self):
+        """Test that chat completions accept every X-Lemonade-Priority class."""
+        requests.post(
+            f"{self.base_url}/load",
+            json={"model_name": ENDPOINT_TEST_MODEL},
+            timeout=TIMEOUT_MODEL_OPERATION,
+        )
+
+        payload = {
+            "model": ENDPOINT_TEST_MODEL,
+            "messages": [{"role": "user", "content": "Hi"}],
+            "max_completion_tokens": 5,
+        }
+        # Unknown values fall back to normal priority
+        for priority in ["interactive", "normal", "batch", "unknown"]:
+            response = requests.post(
+                f"{self.base_url}/chat/completions",
+                json=payload,
+                headers={"X-Lemonade-Priority": priority},
+                timeout=TIMEOUT_MODEL_OPERATION,
+            )
+            self.assertEqual(
+                response.status_code,
+                200,
+                f"Priority {priority} failed: {response.text}",
+            )
+
+        # Browser clients must be allowed to send the header
+        response = requests.options(
+            f"{self.base_url}/chat/completions",
+            headers={
+                "Origin": "http://localhost",
+                "Access-Control-Request-Method": "POST",
+                "Access-Control-Request-Headers": "X-Lemonade-Priority",
+            },
+            timeout=TIMEOUT_DEFAULT,
+        )
+        self.assertIn(
+            "X-Lemonade-Priority",
+            response.headers.get("Access-Control-Allow-Headers", ""),
+        )
+        print("[OK] X-Lemonade-Priority accepted for all classes")
+
+    def test_031_debug_trace(self):
+        """Test that requests get an X-Request-Id and show up in /debug/trace."""
+        response = requests.get(f"{self.base_url}/models", timeout=TIMEOUT_DEFAULT)
+        self.assertEqual(response.status_code, 200)
+        self.assertIn("X-Request-Id", response.headers)
+        request_id = response.headers["X-Request-Id"]
+
+        # Polling endpoints are not traced
+        response = requests.get(f"{self.base_url}/health", timeout=TIMEOUT_DEFAULT)
+        self.assertNotIn("X-Request-Id", response.headers)
+
+        # The request span is recorded after the response is sent, so allow it a moment
+        for _ in range(20):
+            response = requests.get(
+                f"{self.base_url}/debug/trace",
+                params={"request_id": request_id},
+                timeout=TIMEOUT_DEFAULT,
+            )
+            self.assertEqual(response.status_code, 200)
+            events = response.json()["traceEvents"]
+            if any(event["name"] == "request" for event in events):
+                break
+            time.sleep(0.1)
+        self.assertTrue(
+            any(event["name"] == "request" for event in events),
+            f"No request span for request {request_id}: {events}",
+        )
+        for event in events:
+            self.assertEqual(str(event["args"]["request_id"]), request_id)
+            self.assertEqual(event["ph"], "X")
+
+        response = requests.get(
+            f"{self.base_url}/debug/trace",
+            params={"request_id": request_id, "format": "otlp"},
+            timeout=TIMEOUT_DEFAULT,
+        )
+        self.assertEqual(response.status_code, 200)
+        self.assertIn("resourceSpans", response.json())
+
+        print(f"[OK] /debug/trace returned {len(events)} span(s) for request {request_id}")
+
 
 if __name__ == "__main__":
     run_server_tests(EndpointTests, "ENDPOINT TESTS")
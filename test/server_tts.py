@@ -18,6 +18,7 @@ from utils.server_base import (
 )
 from utils.test_models import (
     TTS_MODEL,
+    ENDPOINT_TEST_MODEL,
     PORT,
     TIMEOUT_MODEL_OPERATION,
     TIMEOUT_DEFAULT,
@@ -27,6 +28,9 @@ from utils.test_models import (
 class TextToSpeechTests(ServerTestBase):
     """Tests for Text to Speech."""
 
+    # Enable the speech cache so repeated requests can be replayed
+    additional_server_args = ["--tts-cache-size", "64"]
+
     def test_001_basic_tts(self):
         """Test basic speech generation with Kokoro."""
         payload = {
@@ -187,6 +191,85 @@ class TextToSpeechTests(ServerTestBase):
 
         print(f"[OK] Speech generation successful")
 
+    def test_007_tts_from_chat(self):
+        """Test speaking a chat completion passed in the chat field."""
+        response = requests.post(
+            f"{self.base_url}/pull",
+            json={"model_name": ENDPOINT_TEST_MODEL},
+            timeout=TIMEOUT_MODEL_OPERATION,
+        )
+        self.assertEqual(response.status_code, 200, response.text)
+
+        payload = {
+            "model": TTS_MODEL,
+            "voice": "af_sky",
+            "chat": {
+                "model": ENDPOINT_TEST_MODEL,
+                "messages": [{"role": "user", "content": "Say hello."}],
+                "max_completion_tokens": 20,
+            },
+        }
+
+        print(f"[INFO] Sending chat speech request with model {TTS_MODEL}")
+
+        response = requests.post(
+            f"{self.base_url}/audio/speech",
+            json=payload,
+            timeout=TIMEOUT_MODEL_OPERATION,
+        )
+
+        self.assertEqual(
+            response.status_code,
+            200,
+            f"Chat speech failed with status {response.status_code}: {response.text}",
+        )
+        # The answer is always streamed as raw PCM16 samples
+        self.assertTrue(
+            response.headers.get("Content-Type", "").startswith("audio/l16"),
+            f"Unexpected content type {response.headers.get('Content-Type')}",
+        )
+        self.assertEqual(len(response.content) % 2, 0)
+
+        print(f"[OK] Chat speech returned {len(response.content)} bytes of audio")
+
+    def test_008_tts_cache(self):
+        """Test that a repeated request is replayed from the speech cache."""
+        payload = {
+            "model": TTS_MODEL,
+            "input": "Lemonade remembers what it said",
+            "response_format": "wav",
+        }
+
+        def cache_hits():
+            health = requests.get(f"{self.base_url}/health", timeout=TIMEOUT_DEFAULT)
+            return health.json()["tts_cache"]["hits"]
+
+        first = requests.post(
+            f"{self.base_url}/audio/speech",
+            json=payload,
+            timeout=TIMEOUT_MODEL_OPERATION,
+        )
+        self.assertEqual(first.status_code, 200, first.text)
+        hits_before = cache_hits()
+
+        second = requests.post(
+            f"{self.base_url}/audio/speech",
+            json=payload,
+            timeout=TIMEOUT_MODEL_OPERATION,
+        )
+        self.assertEqual(second.status_code, 200, second.text)
+
+        self.assertEqual(cache_hits(), hits_before + 1)
+        self.assertEqual(first.content, second.content)
+
+        stats = requests.get(f"{self.base_url}/health", timeout=TIMEOUT_DEFAULT).json()[
+            "tts_cache"
+        ]
+        self.assertGreater(stats["entries"], 0)
+        self.assertLessEqual(stats["bytes"], stats["budget_bytes"])
+
+        print(f"[OK] Repeated speech request served from cache: {stats}")
+
 
 if __name__ == "__main__":
     run_server_tests(TextToSpeechTests, "TTS TESTS")